@@ -0,0 +1,47 @@
+/**
+ * \file
+ * \brief File defining modes controlling when sequences which eagerly
+ *     process their input (e.g. sorted or grouped ones) build their result.
+ */
+#pragma once
+
+#include <type_traits>
+
+namespace tpl{
+
+/**
+ * \brief Materialization mode in which the result is rebuilt from the input
+ *     sequence on every call to begin().
+ *
+ * Changes of the input sequence are always visible, but every traversal pays
+ * the full cost of processing the input. This is the default mode.
+ */
+struct rebuild_on_begin_t {};
+
+/**
+ * \brief Materialization mode in which the result is built on first access
+ *     and reused afterwards.
+ *
+ * Changes of the input sequence are not visible until refresh() is called
+ * on the sequence.
+ */
+struct materialize_once_t {};
+
+//! Object of rebuild_on_begin_t which can be passed to sort or group_by.
+const rebuild_on_begin_t rebuild_on_begin;
+
+//! Object of materialize_once_t which can be passed to sort or group_by.
+const materialize_once_t materialize_once;
+
+namespace meta{
+
+template<class T>
+struct is_materialization : std::integral_constant<
+	bool,
+	std::is_same<typename std::decay<T>::type, rebuild_on_begin_t>::value ||
+	std::is_same<typename std::decay<T>::type, materialize_once_t>::value
+> {};
+
+}
+
+}
@@ -0,0 +1,48 @@
+/**
+ * \file
+ * \brief File defining modes controlling whether sequences which lazily
+ *     build and store their content (e.g. cached ones) can be shared between
+ *     threads.
+ */
+#pragma once
+
+#include <type_traits>
+
+namespace tpl{
+
+/**
+ * \brief Synchronization mode in which the stored content is built without
+ *     any synchronization.
+ *
+ * The sequence must not be iterated by many threads at once before its
+ * content is built. This is the default mode.
+ */
+struct single_threaded_t {};
+
+/**
+ * \brief Synchronization mode in which the stored content is built exactly
+ *     once, even if many threads iterate the sequence at once.
+ *
+ * The first thread builds the content while the others wait for it. Once the
+ * content is built, reading it costs single atomic load and takes no lock.
+ */
+struct thread_safe_t {};
+
+//! Object of single_threaded_t which can be passed to cache.
+const single_threaded_t single_threaded;
+
+//! Object of thread_safe_t which can be passed to cache.
+const thread_safe_t thread_safe;
+
+namespace meta{
+
+template<class T>
+struct is_synchronization : std::integral_constant<
+	bool,
+	std::is_same<typename std::decay<T>::type, single_threaded_t>::value ||
+	std::is_same<typename std::decay<T>::type, thread_safe_t>::value
+> {};
+
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <memory>
+
+namespace tpl{
+namespace detail{
+
+//! Allocator of the same kind as Allocator, allocating objects of type T.
+template<class Allocator, class T>
+using rebind_alloc_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+//! Allocator used by materializing sequences unless told otherwise.
+using default_allocator = std::allocator<char>;
+
+}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "iterator_base.hpp"
+
+#include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Iterator over given number of elements starting at wrapped iterator.
+ *
+ * Iterators are compared by number of remaining elements only, so the range
+ * ends even if wrapped iterators never compare equal, as iterators of
+ * generators do.
+ */
+template<class SubIterator>
+class counted_iterator :
+	public input_iterator_base<counted_iterator<SubIterator>> {
+public:
+	using sub_traits_t = std::iterator_traits<SubIterator>;
+	using value_type = typename sub_traits_t::value_type;
+	using difference_type = typename sub_traits_t::difference_type;
+	using reference = typename sub_traits_t::reference;
+	using pointer = typename sub_traits_t::pointer;
+	using iterator_category = typename meta::demote_to_forward_tag<sub_traits_t>::type;
+
+	counted_iterator() = default;
+
+	counted_iterator(SubIterator subIterator, std::size_t remaining) :
+		m_subIterator(std::move(subIterator)),
+		m_remaining(remaining) {}
+
+	counted_iterator &
+	next() {
+		++m_subIterator;
+		--m_remaining;
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		return *m_subIterator;
+	}
+
+	pointer
+	operator->() const {
+		return &*m_subIterator;
+	}
+
+	bool
+	operator==(const counted_iterator &other) const {
+		return m_remaining == other.m_remaining;
+	}
+
+private:
+	SubIterator m_subIterator;
+	std::size_t m_remaining = 0;
+};
+
+/**
+ * Sequence of given number of elements starting at given iterator, viewing
+ * them in place.
+ */
+template<class SubIterator>
+class counted_range {
+public:
+	using value_type = typename std::iterator_traits<SubIterator>::value_type;
+	using iterator = counted_iterator<SubIterator>;
+	using const_iterator = iterator;
+
+	counted_range() = default;
+
+	counted_range(SubIterator first, std::size_t length) :
+		m_first(std::move(first)),
+		m_length(length) {}
+
+	iterator
+	begin() const {
+		return iterator(m_first, m_length);
+	}
+
+	iterator
+	end() const {
+		return iterator(m_first, 0);
+	}
+
+	std::size_t
+	size() const {
+		return m_length;
+	}
+
+	bool
+	empty() const {
+		return m_length == 0;
+	}
+
+	meta::size_hint
+	size_hint() const {
+		return meta::size_hint::exact(m_length);
+	}
+
+private:
+	SubIterator m_first;
+	std::size_t m_length = 0;
+};
+
+}
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "iterator_base.hpp"
+
+#include "../meta/size_hint.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Temporary files holding sorted runs. Files are removed when the last
+ * engine sharing them is destroyed or sorts again.
+ */
+class spill_files {
+public:
+	explicit spill_files(std::string directory) :
+		m_prefix(std::move(directory) + "/tpl-sort-" + std::to_string(std::random_device()()) + "-"),
+		m_paths() {}
+
+	spill_files(const spill_files &) = delete;
+
+	spill_files &
+	operator=(const spill_files &) = delete;
+
+	~spill_files() noexcept {
+		for (const auto &path : m_paths)
+			std::remove(path.c_str());
+	}
+
+	//! Reserves path of next run file.
+	const std::string &
+	add() {
+		m_paths.push_back(m_prefix + std::to_string(m_paths.size()) + ".run");
+		return m_paths.back();
+	}
+
+	const std::vector<std::string> &
+	paths() const {
+		return m_paths;
+	}
+
+private:
+	std::string m_prefix;
+	std::vector<std::string> m_paths;
+};
+
+/**
+ * Single pass iterator over elements merged by external_sort_engine. All
+ * iterators which are not at end share the position of the engine.
+ */
+template<class Engine>
+class external_merge_iterator :
+	public input_iterator_base<external_merge_iterator<Engine>> {
+public:
+	using value_type = typename Engine::value_type;
+	using difference_type = std::ptrdiff_t;
+	using reference = const value_type &;
+	using pointer = const value_type *;
+	using iterator_category = std::input_iterator_tag;
+
+	external_merge_iterator() = default;
+
+	~external_merge_iterator() noexcept = default;
+
+	external_merge_iterator(
+		const Engine *engine,
+		bool isEnd
+	) :
+		m_engine(engine),
+		m_isEnd(isEnd) {}
+
+	external_merge_iterator &
+	next() {
+		m_engine->advance();
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		return m_engine->current();
+	}
+
+	pointer
+	operator->() const {
+		return &m_engine->current();
+	}
+
+	bool
+	operator==(const external_merge_iterator &other) const {
+		return is_end() == other.is_end();
+	}
+
+private:
+	bool
+	is_end() const {
+		return m_isEnd || m_engine->is_exhausted();
+	}
+
+	const Engine *m_engine = nullptr;
+	bool m_isEnd = true;
+};
+
+/**
+ * Engine sorting input which may not fit in memory. Input is read in runs of
+ * at most `memoryBudget / sizeof(ValueType)` elements, each run is stable
+ * sorted and written to a temporary file, and iterators stream a k-way merge
+ * of the runs, reading one element of each run at a time. Input which fits
+ * in a single run is sorted in memory without touching disk.
+ *
+ * Ties between runs are resolved in favor of earlier run, so order of
+ * equivalent elements is the same as with stable sort.
+ */
+template<class ValueType, class Comparison, class Serializer>
+class external_sort_engine {
+public:
+	using value_type = ValueType;
+	using iterator = external_merge_iterator<external_sort_engine>;
+	using const_iterator = iterator;
+
+	template<class T, class Policy>
+	external_sort_engine(T &&comparison, const Policy &policy) :
+		m_comparison(std::forward<T>(comparison)),
+		m_serializer(policy.serializer),
+		m_runLength(std::max<std::size_t>(policy.memoryBudget / sizeof(ValueType), 1)),
+		m_directory(policy.directory) {}
+
+	// Merge position is not shared: copies start reading runs from scratch.
+	external_sort_engine(const external_sort_engine &other) :
+		m_comparison(other.m_comparison),
+		m_serializer(other.m_serializer),
+		m_runLength(other.m_runLength),
+		m_directory(other.m_directory),
+		m_buffer(other.m_buffer),
+		m_runs(other.m_runs) {}
+
+	external_sort_engine &
+	operator=(const external_sort_engine &) = delete;
+
+	~external_sort_engine() noexcept = default;
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		m_merge.reset();
+		m_runs.reset();
+		m_buffer.clear();
+		m_buffer.reserve(std::min(m_runLength, hint.is_bounded() ? hint.value : m_runLength));
+
+		for (; first != last; ++first) {
+			m_buffer.push_back(*first);
+			if (m_buffer.size() == m_runLength)
+				spill();
+		}
+
+		if (!m_runs) {
+			std::stable_sort(std::begin(m_buffer), std::end(m_buffer), m_comparison);
+			return;
+		}
+
+		if (!m_buffer.empty())
+			spill();
+		std::vector<ValueType>().swap(m_buffer);
+	}
+
+	const Comparison &
+	comparison() const {
+		return m_comparison;
+	}
+
+	//! Starts iteration over sorted elements from the first one.
+	const_iterator
+	begin() const {
+		restart();
+		return const_iterator(this, false);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator(this, true);
+	}
+
+	const ValueType &
+	current() const {
+		if (!m_runs)
+			return m_buffer[m_position];
+		return m_merge->heads[m_merge->heap.front()];
+	}
+
+	void
+	advance() const {
+		if (!m_runs) {
+			++m_position;
+			return;
+		}
+
+		auto &heap = m_merge->heap;
+		std::pop_heap(std::begin(heap), std::end(heap), later());
+		if (read(heap.back()))
+			std::push_heap(std::begin(heap), std::end(heap), later());
+		else
+			heap.pop_back();
+	}
+
+	bool
+	is_exhausted() const {
+		if (!m_runs)
+			return m_position >= m_buffer.size();
+		return !m_merge || m_merge->heap.empty();
+	}
+
+private:
+	struct merge_state {
+		std::vector<std::ifstream> streams;
+		std::vector<ValueType> heads;
+		std::vector<std::size_t> heap;
+	};
+
+	void
+	spill() {
+		if (!m_runs)
+			m_runs = std::make_shared<spill_files>(m_directory);
+
+		std::stable_sort(std::begin(m_buffer), std::end(m_buffer), m_comparison);
+		const std::string &path = m_runs->add();
+		std::ofstream stream(path, std::ios::binary);
+		for (const auto &value : m_buffer)
+			m_serializer.write(stream, value);
+		if (!stream)
+			throw std::runtime_error("tpl::external_sort: cannot write " + path);
+		m_buffer.clear();
+	}
+
+	void
+	restart() const {
+		m_position = 0;
+		if (!m_runs)
+			return;
+
+		m_merge = std::make_unique<merge_state>();
+		const auto &paths = m_runs->paths();
+		m_merge->streams.reserve(paths.size());
+		m_merge->heads.resize(paths.size());
+		for (std::size_t run = 0; run != paths.size(); ++run) {
+			m_merge->streams.emplace_back(paths[run], std::ios::binary);
+			if (!m_merge->streams.back())
+				throw std::runtime_error("tpl::external_sort: cannot read " + paths[run]);
+			if (read(run))
+				m_merge->heap.push_back(run);
+		}
+		std::make_heap(std::begin(m_merge->heap), std::end(m_merge->heap), later());
+	}
+
+	bool
+	read(std::size_t run) const {
+		return m_serializer.read(m_merge->streams[run], m_merge->heads[run]);
+	}
+
+	// Heap ordering placing run with the first head in sorted order on top.
+	auto
+	later() const {
+		return [this](std::size_t a, std::size_t b) {
+			const auto &heads = m_merge->heads;
+			return m_comparison(heads[b], heads[a]) ||
+				(!m_comparison(heads[a], heads[b]) && b < a);
+		};
+	}
+
+	Comparison m_comparison;
+	Serializer m_serializer;
+	std::size_t m_runLength;
+	std::string m_directory;
+	std::vector<ValueType> m_buffer;
+	std::shared_ptr<spill_files> m_runs;
+	// Iteration state changes when iterators are advanced.
+	mutable std::unique_ptr<merge_state> m_merge;
+	mutable std::size_t m_position = 0;
+};
+
+}
+}
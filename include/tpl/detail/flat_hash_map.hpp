@@ -0,0 +1,610 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+//! Number of control bytes probed at once by flat_hash_map.
+const std::size_t flat_hash_group_width = 8;
+
+//! Control byte of an empty slot of flat_hash_map.
+const std::uint8_t flat_hash_empty = 0x80;
+
+/**
+ * Iterator over entries of flat_hash_map, referring to them by position.
+ *
+ * End iterator does not remember the number of entries, but compares equal to
+ * any iterator past the last entry, so it stays valid when entries are added
+ * after it was taken, just as end iterator of std::unordered_map does.
+ */
+template<class Entries, class Value>
+class flat_hash_iterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = typename std::remove_const<Value>::type;
+	using difference_type = std::ptrdiff_t;
+	using pointer = Value *;
+	using reference = Value &;
+
+	flat_hash_iterator() = default;
+
+	flat_hash_iterator(Entries *entries, std::size_t index) :
+		m_entries(entries),
+		m_index(index){}
+
+	template<
+		class OtherEntries,
+		class OtherValue,
+		class = typename std::enable_if<std::is_convertible<OtherEntries *, Entries *>::value>::type
+	>
+	flat_hash_iterator(const flat_hash_iterator<OtherEntries, OtherValue> &other) :
+		m_entries(other.entries()),
+		m_index(other.index()){}
+
+	reference
+	operator*() const {
+		return (*m_entries)[m_index];
+	}
+
+	pointer
+	operator->() const {
+		return &(*m_entries)[m_index];
+	}
+
+	flat_hash_iterator &
+	operator++() {
+		++m_index;
+		return *this;
+	}
+
+	flat_hash_iterator
+	operator++(int) {
+		flat_hash_iterator result = *this;
+		++m_index;
+		return result;
+	}
+
+	bool
+	operator==(const flat_hash_iterator &other) const {
+		return position() == other.position();
+	}
+
+	bool
+	operator!=(const flat_hash_iterator &other) const {
+		return !(*this == other);
+	}
+
+	Entries *
+	entries() const {
+		return m_entries;
+	}
+
+	std::size_t
+	index() const {
+		return m_index;
+	}
+
+private:
+	std::size_t
+	position() const {
+		return m_entries ? std::min(m_index, m_entries->size()) : 0;
+	}
+
+	Entries *m_entries = nullptr;
+	std::size_t m_index = 0;
+};
+
+/**
+ * Storage of flat_hash_map entries in blocks of doubling sizes, so that adding
+ * entries never moves the ones already stored.
+ *
+ * Growing a plain vector would copy every entry instead whenever std::pair
+ * with const key may throw on construction, e.g. for std::string keys, and
+ * with the entries all the values they map to, like whole groups of
+ * group_by. Blocks are never relocated, so nothing is copied on growth and
+ * references to entries stay valid until clear().
+ */
+template<class T, class Allocator>
+class flat_hash_entries {
+public:
+	using value_type = T;
+	using allocator_type = rebind_alloc_t<Allocator, T>;
+	using size_type = std::size_t;
+	using traits_t = std::allocator_traits<allocator_type>;
+
+	flat_hash_entries() :
+		m_blocks(),
+		m_allocator() {}
+
+	explicit flat_hash_entries(const allocator_type &allocator) :
+		m_blocks(typename blocks_t::allocator_type(allocator)),
+		m_allocator(allocator) {}
+
+	flat_hash_entries(const flat_hash_entries &other) :
+		flat_hash_entries(traits_t::select_on_container_copy_construction(other.m_allocator)) {
+		append_copies(other);
+	}
+
+	flat_hash_entries(flat_hash_entries &&other) noexcept :
+		m_blocks(std::move(other.m_blocks)),
+		m_size(other.m_size),
+		m_allocator(std::move(other.m_allocator)) {
+		other.m_blocks.clear();
+		other.m_size = 0;
+	}
+
+	// Allocators are replaced only if their propagate_on_container_* traits
+	// say so. Otherwise entries stay in blocks of this allocator and only
+	// entries themselves are copied or moved.
+	flat_hash_entries &
+	operator=(const flat_hash_entries &other) {
+		if (this == &other)
+			return *this;
+
+		clear();
+		if (traits_t::propagate_on_container_copy_assignment::value && !(m_allocator == other.m_allocator)) {
+			// Blocks of this allocator cannot be freed by the new one. Table
+			// of blocks takes allocator of the other one in the same way.
+			release();
+			m_blocks = other.m_blocks;
+			m_blocks.clear();
+		}
+		assign_allocator(other.m_allocator, typename traits_t::propagate_on_container_copy_assignment());
+		append_copies(other);
+		return *this;
+	}
+
+	flat_hash_entries &
+	operator=(flat_hash_entries &&other) noexcept(traits_t::propagate_on_container_move_assignment::value) {
+		if (this == &other)
+			return *this;
+
+		if (traits_t::propagate_on_container_move_assignment::value || m_allocator == other.m_allocator) {
+			release();
+			assign_allocator(std::move(other.m_allocator), typename traits_t::propagate_on_container_move_assignment());
+			m_blocks = std::move(other.m_blocks);
+			m_size = other.m_size;
+			other.m_blocks.clear();
+			other.m_size = 0;
+		} else {
+			clear();
+			reserve(other.size());
+			for (size_type index = 0; index != other.size(); ++index)
+				emplace_back(std::move(other[index]));
+			other.clear();
+		}
+		return *this;
+	}
+
+	~flat_hash_entries() {
+		release();
+	}
+
+	void
+	swap(flat_hash_entries &other) noexcept {
+		using std::swap;
+		swap(m_blocks, other.m_blocks);
+		swap(m_size, other.m_size);
+		swap_allocator(other, typename traits_t::propagate_on_container_swap());
+	}
+
+	allocator_type
+	get_allocator() const {
+		return m_allocator;
+	}
+
+	T &
+	operator[](size_type index) {
+		return at_position(index);
+	}
+
+	const T &
+	operator[](size_type index) const {
+		return at_position(index);
+	}
+
+	size_type
+	size() const {
+		return m_size;
+	}
+
+	bool
+	empty() const {
+		return m_size == 0;
+	}
+
+	template<class... Args>
+	void
+	emplace_back(Args &&... args) {
+		reserve(m_size + 1);
+		traits_t::construct(m_allocator, &at_position(m_size), std::forward<Args>(args)...);
+		++m_size;
+	}
+
+	//! Destroys all entries, keeping allocated blocks.
+	void
+	clear() {
+		for (; m_size != 0; --m_size)
+			traits_t::destroy(m_allocator, &at_position(m_size - 1));
+	}
+
+	void
+	reserve(size_type count) {
+		while (capacity() < count) {
+			// Room for the pointer is made first, so a new block never leaks.
+			m_blocks.reserve(m_blocks.size() + 1);
+			m_blocks.push_back(traits_t::allocate(m_allocator, block_size(m_blocks.size())));
+		}
+	}
+
+private:
+	using blocks_t = std::vector<T *, rebind_alloc_t<Allocator, T *>>;
+
+	void
+	append_copies(const flat_hash_entries &other) {
+		reserve(other.size());
+		for (size_type index = 0; index != other.size(); ++index)
+			emplace_back(other[index]);
+	}
+
+	//! Destroys all entries and frees all blocks.
+	void
+	release() {
+		clear();
+		for (size_type block = 0; block != m_blocks.size(); ++block)
+			traits_t::deallocate(m_allocator, m_blocks[block], block_size(block));
+		m_blocks.clear();
+	}
+
+	template<class OtherAllocator>
+	void
+	assign_allocator(OtherAllocator &&allocator, std::true_type) {
+		m_allocator = std::forward<OtherAllocator>(allocator);
+	}
+
+	template<class OtherAllocator>
+	void
+	assign_allocator(OtherAllocator &&, std::false_type) {}
+
+	void
+	swap_allocator(flat_hash_entries &other, std::true_type) noexcept {
+		using std::swap;
+		swap(m_allocator, other.m_allocator);
+	}
+
+	void
+	swap_allocator(flat_hash_entries &, std::false_type) noexcept {}
+
+	static const size_type first_block_size = 2 * flat_hash_group_width;
+
+	static size_type
+	block_size(size_type block) {
+		return first_block_size << block;
+	}
+
+	static size_type
+	highest_bit(size_type value) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<size_type>(std::numeric_limits<unsigned long long>::digits - 1 -
+			__builtin_clzll(value));
+#else
+		size_type bit = 0;
+		while (value >>= 1)
+			++bit;
+		return bit;
+#endif
+	}
+
+	size_type
+	capacity() const {
+		return first_block_size * ((size_type(1) << m_blocks.size()) - 1);
+	}
+
+	// Block b starts at index first_block_size * (2^b - 1).
+	T &
+	at_position(size_type index) const {
+		const size_type block = highest_bit(index / first_block_size + 1);
+		return m_blocks[block][index - first_block_size * ((size_type(1) << block) - 1)];
+	}
+
+	blocks_t m_blocks;
+	size_type m_size = 0;
+	allocator_type m_allocator;
+};
+
+/**
+ * Open addressing hash map keeping its entries densely, in order of
+ * insertion, so iteration never visits empty slots. Entries are stored in
+ * flat_hash_entries, so they are never copied or moved once inserted.
+ *
+ * Lookup goes through separate index table in the style of Swiss tables:
+ * each slot has a control byte, which is either empty marker or 7 bits of
+ * hash of the key in the slot, and control bytes are probed in groups of
+ * eight, compared all at once with bitwise arithmetic on 64-bit words. Keys
+ * are compared only in slots whose control byte matches, which in practice
+ * means almost only the slot holding the searched key.
+ *
+ * Entries cannot be erased one by one, only all at once with clear(), which
+ * keeps both the dense vector and probe sequences free of holes.
+ *
+ * All the arrays are allocated with copies of given allocator, rebound to
+ * their element types.
+ */
+template<
+	class Key,
+	class Mapped,
+	class Hash = std::hash<Key>,
+	class KeyEqual = std::equal_to<Key>,
+	class Allocator = std::allocator<std::pair<const Key, Mapped>>
+>
+class flat_hash_map {
+public:
+	using key_type = Key;
+	using mapped_type = Mapped;
+	using value_type = std::pair<const Key, Mapped>;
+	using allocator_type = rebind_alloc_t<Allocator, value_type>;
+	using entries_t = flat_hash_entries<value_type, allocator_type>;
+	using iterator = flat_hash_iterator<entries_t, value_type>;
+	using const_iterator = flat_hash_iterator<const entries_t, const value_type>;
+	using size_type = std::size_t;
+
+	flat_hash_map() = default;
+
+	explicit flat_hash_map(const allocator_type &allocator) :
+		m_entries(allocator),
+		m_hashes(allocator),
+		m_control(allocator),
+		m_slots(allocator) {}
+
+	allocator_type
+	get_allocator() const {
+		return m_entries.get_allocator();
+	}
+
+	iterator
+	begin() {
+		return iterator(&m_entries, 0);
+	}
+
+	iterator
+	end() {
+		return iterator(&m_entries, npos());
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator(&m_entries, 0);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator(&m_entries, npos());
+	}
+
+	size_type
+	size() const {
+		return m_entries.size();
+	}
+
+	bool
+	empty() const {
+		return m_entries.empty();
+	}
+
+	//! Removes all entries, keeping allocated memory.
+	void
+	clear() {
+		m_entries.clear();
+		m_hashes.clear();
+		std::fill(m_control.begin(), m_control.end(), flat_hash_empty);
+	}
+
+	//! Makes room for given number of entries without rehashing.
+	void
+	reserve(size_type count) {
+		m_entries.reserve(count);
+		m_hashes.reserve(count);
+		if (count > max_load(m_control.size()))
+			rehash(capacity_for(count));
+	}
+
+	const_iterator
+	find(const Key &key) const {
+		const std::size_t hash = hash_of(key);
+		const std::size_t slot = find_slot(key, hash);
+		return slot == npos() ? end() : const_iterator(&m_entries, m_slots[slot]);
+	}
+
+	iterator
+	find(const Key &key) {
+		const std::size_t hash = hash_of(key);
+		const std::size_t slot = find_slot(key, hash);
+		return slot == npos() ? end() : iterator(&m_entries, m_slots[slot]);
+	}
+
+	size_type
+	count(const Key &key) const {
+		return find(key) == end() ? 0 : 1;
+	}
+
+	/**
+	 * Inserts entry with given key and mapped value constructed from args,
+	 * unless the key is already present. Mapped value is not constructed at
+	 * all in the latter case.
+	 *
+	 * Returns iterator to entry with the key and flag telling if it was added.
+	 */
+	template<class... Args>
+	std::pair<iterator, bool>
+	emplace(const Key &key, Args &&... args) {
+		return emplace_hashed(hash_of(key), key, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Same as emplace(), but takes hash of the key computed earlier with
+	 * hash_of(), so callers which need the hash themselves compute it once.
+	 */
+	template<class... Args>
+	std::pair<iterator, bool>
+	emplace_hashed(std::size_t hash, const Key &key, Args &&... args) {
+		const std::size_t slot = find_slot(key, hash);
+		if (slot != npos())
+			return std::make_pair(iterator(&m_entries, m_slots[slot]), false);
+
+		if (m_entries.size() + 1 > max_load(m_control.size()))
+			rehash(capacity_for(m_entries.size() + 1));
+
+		m_entries.emplace_back(
+			std::piecewise_construct,
+			std::forward_as_tuple(key),
+			std::forward_as_tuple(std::forward<Args>(args)...)
+		);
+		m_hashes.push_back(hash);
+		place(m_entries.size() - 1, hash);
+		return std::make_pair(iterator(&m_entries, m_entries.size() - 1), true);
+	}
+
+	//! Returns hash of key with bits spread, as std::hash of integers is often identity.
+	std::size_t
+	hash_of(const Key &key) const {
+		std::uint64_t hash = m_hash(key);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	//! Returns value mapped to key, inserting default constructed one if needed.
+	Mapped &
+	operator[](const Key &key) {
+		return emplace(key).first->second;
+	}
+
+private:
+	static std::size_t
+	npos() {
+		return static_cast<std::size_t>(-1);
+	}
+
+	static std::uint8_t
+	control_of(std::size_t hash) {
+		return static_cast<std::uint8_t>(hash & 0x7f);
+	}
+
+	static std::size_t
+	max_load(std::size_t capacity) {
+		return capacity - capacity / 8;
+	}
+
+	static std::size_t
+	capacity_for(std::size_t count) {
+		std::size_t capacity = 2 * flat_hash_group_width;
+		while (max_load(capacity) < count)
+			capacity *= 2;
+		return capacity;
+	}
+
+	std::uint64_t
+	load_group(std::size_t group) const {
+		std::uint64_t word = 0;
+		const std::uint8_t *bytes = m_control.data() + group * flat_hash_group_width;
+		for (std::size_t i = 0; i != flat_hash_group_width; ++i)
+			word |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+		return word;
+	}
+
+	// Sets high bit of each byte equal to control, possibly also of some bytes
+	// following an equal one, so every candidate must be verified.
+	static std::uint64_t
+	match(std::uint64_t group, std::uint8_t control) {
+		const std::uint64_t difference = group ^ (0x0101010101010101ull * control);
+		return (difference - 0x0101010101010101ull) & ~difference & 0x8080808080808080ull;
+	}
+
+	static std::uint64_t
+	match_empty(std::uint64_t group) {
+		return group & 0x8080808080808080ull;
+	}
+
+	static std::size_t
+	lowest_byte(std::uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<std::size_t>(__builtin_ctzll(mask)) / 8;
+#else
+		std::size_t byte = 0;
+		while ((mask & 0xff) == 0) {
+			mask >>= 8;
+			++byte;
+		}
+		return byte;
+#endif
+	}
+
+	std::size_t
+	find_slot(const Key &key, std::size_t hash) const {
+		if (m_control.empty())
+			return npos();
+
+		const std::size_t groupMask = m_control.size() / flat_hash_group_width - 1;
+		std::size_t group = (hash >> 7) & groupMask;
+		for (std::size_t step = 1; ; ++step) {
+			const std::uint64_t controls = load_group(group);
+			for (std::uint64_t candidates = match(controls, control_of(hash)); candidates; candidates &= candidates - 1) {
+				const std::size_t slot = group * flat_hash_group_width + lowest_byte(candidates);
+				const std::size_t entry = m_slots[slot];
+				if (m_control[slot] == control_of(hash) && m_hashes[entry] == hash && m_equal(m_entries[entry].first, key))
+					return slot;
+			}
+			if (match_empty(controls))
+				return npos();
+			group = (group + step) & groupMask;
+		}
+	}
+
+	void
+	place(std::size_t entry, std::size_t hash) {
+		const std::size_t groupMask = m_control.size() / flat_hash_group_width - 1;
+		std::size_t group = (hash >> 7) & groupMask;
+		for (std::size_t step = 1; ; ++step) {
+			const std::uint64_t empty = match_empty(load_group(group));
+			if (empty) {
+				const std::size_t slot = group * flat_hash_group_width + lowest_byte(empty);
+				m_control[slot] = control_of(hash);
+				m_slots[slot] = entry;
+				return;
+			}
+			group = (group + step) & groupMask;
+		}
+	}
+
+	void
+	rehash(std::size_t capacity) {
+		m_control.assign(capacity, flat_hash_empty);
+		m_slots.assign(capacity, 0);
+		for (std::size_t entry = 0; entry != m_entries.size(); ++entry)
+			place(entry, m_hashes[entry]);
+	}
+
+	entries_t m_entries;
+	std::vector<std::size_t, rebind_alloc_t<Allocator, std::size_t>> m_hashes;
+	std::vector<std::uint8_t, rebind_alloc_t<Allocator, std::uint8_t>> m_control;
+	std::vector<std::size_t, rebind_alloc_t<Allocator, std::size_t>> m_slots;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+}
+}
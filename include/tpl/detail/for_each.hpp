@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../meta/has_for_each.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/*
+ * Callbacks of push-based iteration may return bool, in which case false
+ * stops the iteration, or nothing, in which case iteration always continues.
+ */
+template<class Callback, class Value>
+typename std::enable_if<
+	std::is_void<decltype(std::declval<Callback &>()(std::declval<Value>()))>::value,
+	bool
+>::type
+invoke_callback(Callback &callback, Value &&value) {
+	callback(std::forward<Value>(value));
+	return true;
+}
+
+template<class Callback, class Value>
+typename std::enable_if<
+	!std::is_void<decltype(std::declval<Callback &>()(std::declval<Value>()))>::value,
+	bool
+>::type
+invoke_callback(Callback &callback, Value &&value) {
+	if (callback(std::forward<Value>(value)))
+		return true;
+	return false;
+}
+
+/**
+ * Calls callback with each element of enumerable until the callback returns
+ * false. Sequences implementing for_each member function push elements
+ * themselves, all other sequences are traversed with iterators.
+ *
+ * Returns false if the iteration was stopped by the callback and true if
+ * all elements were visited.
+ */
+template<class Enumerable, class Callback>
+typename std::enable_if<meta::has_for_each<Enumerable>::value, bool>::type
+for_each(const Enumerable &enumerable, Callback &&callback) {
+	return enumerable.for_each(callback);
+}
+
+template<class Enumerable, class Callback>
+typename std::enable_if<!meta::has_for_each<Enumerable>::value, bool>::type
+for_each(const Enumerable &enumerable, Callback &&callback) {
+	const auto last = std::end(enumerable);
+	for (auto first = std::begin(enumerable); first != last; ++first)
+		if (!invoke_callback(callback, *first))
+			return false;
+	return true;
+}
+
+}
+}
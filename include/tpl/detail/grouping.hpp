@@ -0,0 +1,231 @@
+#pragma once
+
+#include "flat_hash_map.hpp"
+#include "parallel_reduce.hpp"
+
+#include "../executor/executor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Returns iterator to entry of table with given key, inserting one with
+ * mapped value constructed from args if there is none. Args are not used if
+ * the key is present.
+ */
+template<class Key, class Mapped, class Hash, class KeyEqual, class Allocator, class... Args>
+typename flat_hash_map<Key, Mapped, Hash, KeyEqual, Allocator>::iterator
+find_or_emplace(
+	flat_hash_map<Key, Mapped, Hash, KeyEqual, Allocator> &table,
+	const Key &key,
+	Args &&... args
+) {
+	return table.emplace(key, std::forward<Args>(args)...).first;
+}
+
+// Emplacing into std::unordered_map allocates a node even if the key is
+// present, so the key is looked up first.
+template<class Table, class... Args>
+typename Table::iterator
+find_or_emplace(Table &table, const typename Table::key_type &key, Args &&... args) {
+	auto found = table.find(key);
+	if (found == std::end(table))
+		found = table.emplace(key, typename Table::mapped_type(std::forward<Args>(args)...)).first;
+	return found;
+}
+
+/**
+ * Appends elements of [first, last) to groups of table, keyed with results of
+ * grouping function. Groups are created with allocator of the table. Each
+ * element is read once, so computed elements are not computed again.
+ */
+template<class Iterator, class Table, class Grouping>
+void
+group(Iterator first, Iterator last, Table &grouped, Grouping &grouping) {
+	const auto allocator = grouped.get_allocator();
+	for (; first != last; ++first) {
+		auto &&value = *first;
+		find_or_emplace(grouped, grouping(value), allocator)->second.push_back(
+			std::forward<decltype(value)>(value)
+		);
+	}
+}
+
+/**
+ * Group built by one thread of parallel grouping, remembering position of its
+ * first element in the input, so groups can be ordered as in sequential
+ * grouping at the end.
+ */
+template<class Mapped>
+struct partial_group {
+	template<class Allocator>
+	partial_group(std::size_t first, const Allocator &allocator) :
+		firstIndex(first),
+		values(typename Mapped::allocator_type(allocator)) {}
+
+	std::size_t firstIndex;
+	Mapped values;
+};
+
+template<class Iterator, class Table, class Grouping>
+void
+parallel_group(
+	Iterator first,
+	Iterator last,
+	Table &grouped,
+	Grouping &grouping,
+	executor &,
+	unsigned,
+	std::input_iterator_tag
+) {
+	group(first, last, grouped, grouping);
+}
+
+/**
+ * Groups random access range on executor.
+ *
+ * Input is split into chunks and each chunk is grouped by one thread into its
+ * own tables, one per hash partition. Then each partition is merged by one
+ * thread, appending groups of later chunks to groups of earlier ones. Keys of
+ * different partitions never meet, so no table is shared between threads.
+ * Finally groups are moved to the output table in order of first occurrence
+ * of their keys.
+ *
+ * Result is identical to the one of group(): groups are ordered by first
+ * occurrence of their keys and elements of every group keep order of input,
+ * regardless of number of chunks and of thread scheduling. Tables of chunks
+ * and their groups are allocated with allocator of the output table.
+ */
+template<class Iterator, class Table, class Grouping>
+void
+parallel_group(
+	Iterator first,
+	Iterator last,
+	Table &grouped,
+	Grouping &grouping,
+	executor &chunkExecutor,
+	unsigned concurrency,
+	std::random_access_iterator_tag
+) {
+	using key_type = typename Table::key_type;
+	using mapped_type = typename Table::mapped_type;
+	using allocator_t = typename Table::allocator_type;
+	using partition_t = flat_hash_map<
+		key_type,
+		partial_group<mapped_type>,
+		std::hash<key_type>,
+		std::equal_to<key_type>,
+		rebind_alloc_t<allocator_t, std::pair<const key_type, partial_group<mapped_type>>>
+	>;
+
+	const std::size_t length = static_cast<std::size_t>(last - first);
+	const std::size_t chunks = std::max<std::size_t>(
+		std::min<std::size_t>(
+			concurrency,
+			length / static_cast<std::size_t>(min_chunk_length)
+		),
+		1
+	);
+	if (chunks == 1) {
+		group(first, last, grouped, grouping);
+		return;
+	}
+
+	// Partition is chosen with high bits of hash, as low ones pick slots.
+	const std::size_t partitions = chunks;
+	const auto partitionOf = [partitions](std::size_t hash) {
+		return (hash >> (std::numeric_limits<std::size_t>::digits / 2)) % partitions;
+	};
+
+	const allocator_t allocator = grouped.get_allocator();
+	const typename partition_t::allocator_type partitionAllocator(allocator);
+	std::vector<partition_t, rebind_alloc_t<allocator_t, partition_t>> tables(
+		chunks * partitions,
+		partition_t(partitionAllocator),
+		rebind_alloc_t<allocator_t, partition_t>(allocator)
+	);
+	chunkExecutor.parallel_for(0, chunks, 1, [&](std::size_t chunkFirst, std::size_t chunkLast) {
+		for (; chunkFirst != chunkLast; ++chunkFirst) {
+			partition_t *const chunkTables = tables.data() + chunkFirst * partitions;
+			const std::size_t indexLast = length * (chunkFirst + 1) / chunks;
+			for (std::size_t index = length * chunkFirst / chunks; index != indexLast; ++index) {
+				const auto &value = first[static_cast<std::ptrdiff_t>(index)];
+				const key_type key = grouping(value);
+				const std::size_t hash = chunkTables->hash_of(key);
+				chunkTables[partitionOf(hash)]
+					.emplace_hashed(hash, key, index, allocator)
+					.first->second.values.push_back(value);
+			}
+		}
+	});
+
+	// Chunks are merged in order, so tables of the first chunk end up
+	// holding all groups, with the earliest first index of every key.
+	chunkExecutor.parallel_for(0, partitions, 1, [&](std::size_t partitionFirst, std::size_t partitionLast) {
+		for (; partitionFirst != partitionLast; ++partitionFirst) {
+			partition_t &merged = tables[partitionFirst];
+			for (std::size_t chunk = 1; chunk != chunks; ++chunk) {
+				partition_t &partial = tables[chunk * partitions + partitionFirst];
+				for (auto &entry : partial) {
+					auto &target = merged.emplace(entry.first, entry.second.firstIndex, allocator).first->second.values;
+					target.insert(
+						std::end(target),
+						std::make_move_iterator(std::begin(entry.second.values)),
+						std::make_move_iterator(std::end(entry.second.values))
+					);
+				}
+				partial = partition_t(partitionAllocator);
+			}
+		}
+	});
+
+	using entry_pointer_t = typename partition_t::value_type *;
+	const rebind_alloc_t<allocator_t, entry_pointer_t> orderAllocator(allocator);
+	std::vector<entry_pointer_t, rebind_alloc_t<allocator_t, entry_pointer_t>> order(orderAllocator);
+	for (std::size_t partition = 0; partition != partitions; ++partition)
+		for (auto &entry : tables[partition])
+			order.push_back(&entry);
+	std::sort(std::begin(order), std::end(order), [](const auto *left, const auto *right) {
+		return left->second.firstIndex < right->second.firstIndex;
+	});
+
+	grouped.reserve(order.size());
+	for (auto *entry : order)
+		grouped.emplace(entry->first, std::move(entry->second.values));
+}
+
+/**
+ * Groups [first, last) on executor if the range is random access and
+ * sequentially otherwise.
+ */
+template<class Iterator, class Table, class Grouping>
+void
+parallel_group(
+	Iterator first,
+	Iterator last,
+	Table &grouped,
+	Grouping &grouping,
+	executor &chunkExecutor,
+	unsigned concurrency
+) {
+	parallel_group(
+		first,
+		last,
+		grouped,
+		grouping,
+		chunkExecutor,
+		concurrency,
+		typename std::iterator_traits<Iterator>::iterator_category()
+	);
+}
+
+}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "iterator_base.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Random access iterator addressing elements of contiguous container by
+ * position rather than by address. Iterator created with end() always points
+ * past the last element, even if the container was refilled in the meantime,
+ * so it stays valid across rebuilding of the container.
+ */
+template<class Container>
+class index_iterator : public random_access_iterator_base<index_iterator<Container>> {
+public:
+	using value_type = typename Container::value_type;
+	using difference_type = std::ptrdiff_t;
+	using reference = const value_type &;
+	using pointer = const value_type *;
+	using iterator_category = std::random_access_iterator_tag;
+
+	index_iterator() = default;
+
+	~index_iterator() noexcept = default;
+
+	index_iterator(
+		const Container *container,
+		std::size_t index
+	) :
+		m_container(container),
+		m_index(index) {}
+
+	static index_iterator
+	begin(const Container *container) {
+		return index_iterator(container, 0);
+	}
+
+	static index_iterator
+	end(const Container *container) {
+		return index_iterator(container, past_the_end);
+	}
+
+	index_iterator &
+	next() {
+		m_index = position() + 1;
+		return *this;
+	}
+
+	index_iterator &
+	previous() {
+		m_index = position() - 1;
+		return *this;
+	}
+
+	index_iterator &
+	advance(difference_type offset) {
+		m_index = static_cast<std::size_t>(static_cast<difference_type>(position()) + offset);
+		return *this;
+	}
+
+	difference_type
+	distance_to(const index_iterator &other) const {
+		return static_cast<difference_type>(other.position()) -
+			static_cast<difference_type>(position());
+	}
+
+	reference
+	operator*() const {
+		return (*m_container)[position()];
+	}
+
+	pointer
+	operator->() const {
+		return &**this;
+	}
+
+	bool
+	operator==(const index_iterator &other) const {
+		return position() == other.position();
+	}
+
+private:
+	static constexpr std::size_t past_the_end = std::numeric_limits<std::size_t>::max();
+
+	std::size_t
+	position() const {
+		return m_index == past_the_end ? m_container->size() : m_index;
+	}
+
+	const Container *m_container = nullptr;
+	std::size_t m_index = 0;
+};
+
+}
+}
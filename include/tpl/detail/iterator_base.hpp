@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
 namespace tpl{
 namespace detail{
 
@@ -62,5 +66,64 @@ protected:
 	~bidirectional_iterator_base() noexcept = default;
 };
 
+template<class Derived, class Difference = std::ptrdiff_t>
+class random_access_iterator_base : public bidirectional_iterator_base<Derived> {
+public:
+	Derived &operator+=(Difference offset) {
+		return this->derived_this().advance(offset);
+	}
+
+	Derived &operator-=(Difference offset) {
+		return this->derived_this().advance(-offset);
+	}
+
+	Derived operator+(Difference offset) const {
+		auto temp = this->derived_this();
+		return temp += offset;
+	}
+
+	friend Derived operator+(Difference offset, const Derived &iterator) {
+		return iterator + offset;
+	}
+
+	Derived operator-(Difference offset) const {
+		auto temp = this->derived_this();
+		return temp -= offset;
+	}
+
+	Difference operator-(const Derived &other) const {
+		return other.distance_to(this->derived_this());
+	}
+
+	decltype(auto) operator[](Difference offset) const {
+		return *(this->derived_this() + offset);
+	}
+
+	bool operator<(const Derived &other) const {
+		return this->derived_this().distance_to(other) > 0;
+	}
+
+	bool operator>(const Derived &other) const {
+		return other < this->derived_this();
+	}
+
+	bool operator<=(const Derived &other) const {
+		return !(other < this->derived_this());
+	}
+
+	bool operator>=(const Derived &other) const {
+		return !(this->derived_this() < other);
+	}
+protected:
+	~random_access_iterator_base() noexcept = default;
+};
+
+template<class Derived, class Category, class Difference>
+using bidirectional_or_random_access_iterator_base = typename std::conditional<
+	std::is_same<Category, std::random_access_iterator_tag>::value,
+	random_access_iterator_base<Derived, Difference>,
+	bidirectional_iterator_base<Derived>
+>::type;
+
 }
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Lazily computed iterator stored inside of a sequence. Cached iterator may
+ * point into the sequence owning the cache, so copying or moving the cache
+ * does not transfer the iterator - the copy computes it again on first use.
+ */
+template<class Iterator>
+class iterator_cache {
+public:
+	iterator_cache() = default;
+
+	iterator_cache(const iterator_cache &) noexcept {}
+
+	iterator_cache(iterator_cache &&) noexcept {}
+
+	iterator_cache &
+	operator=(const iterator_cache &) noexcept {
+		reset();
+		return *this;
+	}
+
+	iterator_cache &
+	operator=(iterator_cache &&) noexcept {
+		reset();
+		return *this;
+	}
+
+	~iterator_cache() noexcept = default;
+
+	template<class Function>
+	const Iterator &
+	get(Function &&compute) {
+		if (!m_isSet) {
+			m_iterator = std::forward<Function>(compute)();
+			m_isSet = true;
+		}
+		return m_iterator;
+	}
+
+	void
+	reset() noexcept {
+		m_isSet = false;
+	}
+
+private:
+	Iterator m_iterator{};
+	bool m_isSet = false;
+};
+
+/**
+ * Begin positions of a sequence, cached separately for iterator and
+ * const_iterator. Both are computed by calling begin() of the wrapped
+ * sequence, which may rebuild its storage, so computing one of them
+ * discards the other.
+ *
+ * If IsEnabled is false, positions are never cached. It is meant for wrapped
+ * sequences whose every begin() rebuilds their storage (see
+ * meta::rebuilds_on_begin), as then no cached iterator stays valid.
+ */
+template<class Iterator, class ConstIterator, bool IsEnabled>
+class begin_cache {
+public:
+	template<class Function>
+	Iterator
+	get(Function &&compute) {
+		m_constBegin.reset();
+		return m_begin.get(std::forward<Function>(compute));
+	}
+
+	template<class Function>
+	ConstIterator
+	get_const(Function &&compute) {
+		m_begin.reset();
+		return m_constBegin.get(std::forward<Function>(compute));
+	}
+
+	void
+	reset() noexcept {
+		m_begin.reset();
+		m_constBegin.reset();
+	}
+
+private:
+	iterator_cache<Iterator> m_begin;
+	iterator_cache<ConstIterator> m_constBegin;
+};
+
+template<class Iterator, class ConstIterator>
+class begin_cache<Iterator, ConstIterator, false> {
+public:
+	template<class Function>
+	Iterator
+	get(Function &&compute) {
+		return std::forward<Function>(compute)();
+	}
+
+	template<class Function>
+	ConstIterator
+	get_const(Function &&compute) {
+		return std::forward<Function>(compute)();
+	}
+
+	void
+	reset() noexcept {}
+};
+
+}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include "../meta/enumerable_traits.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Prefix of a sequence read so far, extended on demand. Elements are stored
+ * in std::deque, so references to them stay valid while the prefix grows.
+ *
+ * Stored iterators point into the sequence owning the buffer, so copying or
+ * moving the buffer does not transfer the prefix - the copy reads the
+ * sequence again, like iterator_cache does. Only the allocator is copied.
+ */
+template<class Iterator, class ValueType, class Allocator = default_allocator>
+class memo_buffer {
+public:
+	using values_t = std::deque<ValueType, rebind_alloc_t<Allocator, ValueType>>;
+
+	memo_buffer() = default;
+
+	explicit memo_buffer(const Allocator &allocator) :
+		m_values(typename values_t::allocator_type(allocator)) {}
+
+	memo_buffer(const memo_buffer &other) :
+		m_values(other.m_values.get_allocator()) {}
+
+	memo_buffer(memo_buffer &&other) :
+		m_values(other.m_values.get_allocator()) {}
+
+	memo_buffer &
+	operator=(const memo_buffer &) {
+		reset();
+		return *this;
+	}
+
+	memo_buffer &
+	operator=(memo_buffer &&) {
+		reset();
+		return *this;
+	}
+
+	~memo_buffer() noexcept = default;
+
+	/**
+	 * Reads elements of enumerable until the one at given index is stored.
+	 * Returns false if enumerable ends before it.
+	 */
+	template<class Enumerable>
+	bool
+	reach(std::size_t index, const Enumerable &enumerable) {
+		if (index < m_values.size())
+			return true;
+
+		if (!m_cursor)
+			m_cursor.reset(new cursor{
+				meta::enumerable_traits<Enumerable>::begin(enumerable),
+				meta::enumerable_traits<Enumerable>::end(enumerable)
+			});
+		while (index >= m_values.size()) {
+			if (m_cursor->next == m_cursor->last)
+				return false;
+			m_values.push_back(*m_cursor->next);
+			++m_cursor->next;
+		}
+		return true;
+	}
+
+	const ValueType &
+	operator[](std::size_t index) const {
+		return m_values[index];
+	}
+
+	std::size_t
+	size() const noexcept {
+		return m_values.size();
+	}
+
+	void
+	reset() noexcept {
+		m_values.clear();
+		m_cursor.reset();
+	}
+
+private:
+	// Iterators are created on first read, as not all of them are default
+	// constructible.
+	struct cursor {
+		Iterator next;
+		Iterator last;
+	};
+
+	values_t m_values;
+	std::unique_ptr<cursor> m_cursor;
+};
+
+}
+}
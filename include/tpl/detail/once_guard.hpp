@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../common/synchronization.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Runs function given to call() only until it completes once. Copies of
+ * the guard remember if the function was completed, but only for the guarded
+ * object they were copied with.
+ */
+template<class Synchronization>
+class once_guard;
+
+template<>
+class once_guard<single_threaded_t> {
+public:
+	bool
+	is_done() const noexcept {
+		return m_isDone;
+	}
+
+	template<class Function>
+	void
+	call(Function &&function) {
+		if (m_isDone)
+			return;
+
+		std::forward<Function>(function)();
+		m_isDone = true;
+	}
+
+private:
+	bool m_isDone = false;
+};
+
+/**
+ * Guard based on double-checked locking: completed guard is recognised with
+ * single acquire load, and the mutex is only taken until then. If the
+ * function throws, the next call runs it again.
+ */
+template<>
+class once_guard<thread_safe_t> {
+public:
+	once_guard() = default;
+
+	once_guard(const once_guard &other) noexcept :
+		m_isDone(other.is_done()) {}
+
+	once_guard &
+	operator=(const once_guard &other) noexcept {
+		m_isDone.store(other.is_done(), std::memory_order_release);
+		return *this;
+	}
+
+	~once_guard() noexcept = default;
+
+	bool
+	is_done() const noexcept {
+		return m_isDone.load(std::memory_order_acquire);
+	}
+
+	template<class Function>
+	void
+	call(Function &&function) {
+		if (is_done())
+			return;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_isDone.load(std::memory_order_relaxed))
+			return;
+
+		std::forward<Function>(function)();
+		m_isDone.store(true, std::memory_order_release);
+	}
+
+private:
+	std::atomic<bool> m_isDone{ false };
+	std::mutex m_mutex;
+};
+
+}
+}
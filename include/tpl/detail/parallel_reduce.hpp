@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../meta/is_parallel.hpp"
+
+#include "../executor/executor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+//! Pair of iterators which can be traversed like a sequence.
+template<class Iterator>
+class iterator_range {
+public:
+	iterator_range(Iterator first, Iterator last) :
+		m_first(std::move(first)),
+		m_last(std::move(last)) {}
+
+	Iterator
+	begin() const {
+		return m_first;
+	}
+
+	Iterator
+	end() const {
+		return m_last;
+	}
+
+private:
+	Iterator m_first;
+	Iterator m_last;
+};
+
+//! Smallest number of elements which is worth processing on separate thread.
+const std::ptrdiff_t min_chunk_length = 1024;
+
+/**
+ * Splits [first, last) into at most `concurrency` chunks of similar length and
+ * calls `reduceChunk(chunk, isLeading)` for each of them on given executor,
+ * where `isLeading` is true only for the first chunk. Partial results are
+ * combined in order of chunks, so `combineResults` is only required to be
+ * associative.
+ */
+template<class Iterator, class Reduce, class Combine>
+auto
+reduce_chunks(
+	Iterator first,
+	Iterator last,
+	executor &chunkExecutor,
+	unsigned concurrency,
+	Reduce &reduceChunk,
+	Combine &combineResults
+) -> decltype(reduceChunk(iterator_range<Iterator>(first, last), true)) {
+	using result_t = decltype(reduceChunk(iterator_range<Iterator>(first, last), true));
+
+	const std::ptrdiff_t length = last - first;
+	const std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(
+		std::min<std::ptrdiff_t>(concurrency, length / min_chunk_length),
+		1
+	);
+	const std::ptrdiff_t chunkLength = length / chunks;
+	const std::ptrdiff_t leadingLength = length - chunkLength * (chunks - 1);
+
+	std::vector<std::unique_ptr<result_t>> partials(static_cast<std::size_t>(chunks));
+	chunkExecutor.parallel_for(
+		0,
+		partials.size(),
+		1,
+		[&](std::size_t chunkFirst, std::size_t chunkLast) {
+			for (std::size_t chunk = chunkFirst; chunk != chunkLast; ++chunk) {
+				const bool isLeading = chunk == 0;
+				const auto chunkBegin = isLeading ?
+					first :
+					first + leadingLength + chunkLength * static_cast<std::ptrdiff_t>(chunk - 1);
+				const auto chunkEnd = isLeading ?
+					first + leadingLength :
+					chunkBegin + chunkLength;
+				partials[chunk] = std::make_unique<result_t>(
+					reduceChunk(iterator_range<Iterator>(chunkBegin, chunkEnd), isLeading)
+				);
+			}
+		}
+	);
+
+	result_t result = std::move(*partials.front());
+	for (std::size_t chunk = 1; chunk != partials.size(); ++chunk)
+		result = combineResults(std::move(result), std::move(*partials[chunk]));
+	return result;
+}
+
+/**
+ * Reduces sequence with given functions. Sequences marked with tpl::par are
+ * split into chunks reduced concurrently (see reduce_chunks), all other ones
+ * are passed as a whole to `reduceChunk(enumerable, true)`.
+ */
+template<class Enumerable, class Reduce, class Combine>
+auto
+reduce(const Enumerable &enumerable, Reduce &&reduceChunk, Combine &&combineResults)
+	-> typename std::enable_if<
+		meta::is_parallel<Enumerable>::value,
+		decltype(reduceChunk(enumerable, true))
+	>::type {
+	return enumerable.reduce(reduceChunk, combineResults);
+}
+
+template<class Enumerable, class Reduce, class Combine>
+auto
+reduce(const Enumerable &enumerable, Reduce &&reduceChunk, Combine &&)
+	-> typename std::enable_if<
+		!meta::is_parallel<Enumerable>::value,
+		decltype(reduceChunk(enumerable, true))
+	>::type {
+	return reduceChunk(enumerable, true);
+}
+
+}
+}
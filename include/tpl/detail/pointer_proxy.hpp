@@ -1,4 +1,6 @@
 
+#pragma once
+
 #include <utility>
 
 namespace tpl{
@@ -8,7 +10,8 @@ template<class T>
 class pointer_proxy {
 public:
 	pointer_proxy(T &&value) : m_value(std::forward<T>(value)) {}
-	T *operator ->() const { return &m_value; }
+	T *operator ->() { return &m_value; }
+	const T *operator ->() const { return &m_value; }
 
 private:
 	T m_value;
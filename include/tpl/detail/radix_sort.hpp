@@ -0,0 +1,200 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Checks if Key can be mapped to unsigned integer of the same width so that
+ * order of the integers is the order of keys, i.e. if Key is integral or
+ * IEEE 754 float or double.
+ */
+template<class Key>
+struct is_radix_key : std::integral_constant<
+	bool,
+	std::is_integral<Key>::value ||
+	(
+		std::is_floating_point<Key>::value &&
+		std::numeric_limits<Key>::is_iec559 &&
+		(sizeof(Key) == sizeof(std::uint32_t) || sizeof(Key) == sizeof(std::uint64_t))
+	)
+> {};
+
+template<std::size_t Size>
+struct radix_unsigned;
+
+template<>
+struct radix_unsigned<1> { using type = std::uint8_t; };
+
+template<>
+struct radix_unsigned<2> { using type = std::uint16_t; };
+
+template<>
+struct radix_unsigned<4> { using type = std::uint32_t; };
+
+template<>
+struct radix_unsigned<8> { using type = std::uint64_t; };
+
+template<class Key>
+using radix_unsigned_t = typename radix_unsigned<sizeof(Key)>::type;
+
+template<class Key>
+typename std::enable_if<std::is_integral<Key>::value, radix_unsigned_t<Key>>::type
+radix_encode(Key key) {
+	using unsigned_t = radix_unsigned_t<Key>;
+	unsigned_t bits = key;
+	if (std::is_signed<Key>::value)
+		bits ^= unsigned_t(1) << (8 * sizeof(Key) - 1);
+	return bits;
+}
+
+template<class Key>
+typename std::enable_if<std::is_floating_point<Key>::value, radix_unsigned_t<Key>>::type
+radix_encode(Key key) {
+	using unsigned_t = radix_unsigned_t<Key>;
+	const unsigned_t signBit = unsigned_t(1) << (8 * sizeof(Key) - 1);
+
+	// -0.0 compares equal to 0.0, so both are given the same code.
+	if (key == Key(0))
+		key = Key(0);
+
+	unsigned_t bits;
+	std::memcpy(&bits, &key, sizeof(Key));
+	return (bits & signBit) ? ~bits : bits | signBit;
+}
+
+/**
+ * Computes stable ascending order of elements by their codes with least
+ * significant digit radix sort, one byte per pass. Passes in which all codes
+ * share the same byte are skipped. Returns positions of elements in the
+ * sorted order. All buffers are allocated with allocator of codes.
+ *
+ * Complexity is O(N * sizeof(Code)) time and O(N) additional memory.
+ */
+template<class Code, class Allocator>
+std::vector<std::size_t, rebind_alloc_t<Allocator, std::size_t>>
+radix_order(const std::vector<Code, Allocator> &codes) {
+	using item_t = std::pair<Code, std::size_t>;
+	using histogram_t = std::array<std::size_t, 256>;
+	using order_t = std::vector<std::size_t, rebind_alloc_t<Allocator, std::size_t>>;
+	using items_t = std::vector<item_t, rebind_alloc_t<Allocator, item_t>>;
+	const std::size_t digits = sizeof(Code);
+	const Allocator allocator = codes.get_allocator();
+
+	order_t order{ typename order_t::allocator_type(allocator) };
+	if (codes.empty())
+		return order;
+
+	std::vector<histogram_t, rebind_alloc_t<Allocator, histogram_t>> histograms(
+		digits,
+		histogram_t(),
+		rebind_alloc_t<Allocator, histogram_t>(allocator)
+	);
+	for (auto &histogram : histograms)
+		histogram.fill(0);
+	for (const Code code : codes)
+		for (std::size_t digit = 0; digit != digits; ++digit)
+			++histograms[digit][(code >> (8 * digit)) & 0xff];
+
+	items_t items{ typename items_t::allocator_type(allocator) };
+	items.reserve(codes.size());
+	for (std::size_t index = 0; index != codes.size(); ++index)
+		items.emplace_back(codes[index], index);
+
+	items_t scratch(items.size(), item_t(), typename items_t::allocator_type(allocator));
+	for (std::size_t digit = 0; digit != digits; ++digit) {
+		auto &histogram = histograms[digit];
+		if (histogram[(items.front().first >> (8 * digit)) & 0xff] == items.size())
+			continue;
+
+		std::size_t offset = 0;
+		for (auto &count : histogram) {
+			const std::size_t bucketSize = count;
+			count = offset;
+			offset += bucketSize;
+		}
+		for (const auto &item : items)
+			scratch[histogram[(item.first >> (8 * digit)) & 0xff]++] = item;
+		items.swap(scratch);
+	}
+
+	order.reserve(items.size());
+	for (const auto &item : items)
+		order.push_back(item.second);
+	return order;
+}
+
+/**
+ * Comparison of elements by keys computed by projection, i.e.
+ * `keyComparison(projection(a), projection(b))`.
+ */
+template<class Projection, class KeyComparison>
+class key_comparison {
+public:
+	key_comparison(Projection projection, KeyComparison keyComparison) :
+		m_projection(std::move(projection)),
+		m_keyComparison(std::move(keyComparison)) {}
+
+	template<class T, class U>
+	bool
+	operator()(const T &a, const U &b) const {
+		return m_keyComparison(m_projection(a), m_projection(b));
+	}
+
+	const Projection &
+	projection() const {
+		return m_projection;
+	}
+
+	const KeyComparison &
+	key_comparator() const {
+		return m_keyComparison;
+	}
+
+private:
+	Projection m_projection;
+	KeyComparison m_keyComparison;
+};
+
+/**
+ * Tells if KeyComparison orders keys of type Key in ascending (`<`) or
+ * descending (`>`) order. Only such comparisons of radix keys can be replaced
+ * with radix sort.
+ */
+template<class KeyComparison, class Key>
+struct radix_direction {
+	static const bool is_known = false;
+	static const bool is_descending = false;
+};
+
+template<class Key>
+struct radix_direction<std::less<>, Key> {
+	static const bool is_known = true;
+	static const bool is_descending = false;
+};
+
+template<class Key>
+struct radix_direction<std::less<Key>, Key> : radix_direction<std::less<>, Key> {};
+
+template<class Key>
+struct radix_direction<std::greater<>, Key> {
+	static const bool is_known = true;
+	static const bool is_descending = true;
+};
+
+template<class Key>
+struct radix_direction<std::greater<Key>, Key> : radix_direction<std::greater<>, Key> {};
+
+}
+}
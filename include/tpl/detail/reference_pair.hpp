@@ -0,0 +1,69 @@
+#pragma once
+
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Pair of references returned by iterators which combine elements of two
+ * sequences, so that dereferencing them copies no element. For elements
+ * returned by value (e.g. from transform) the pair holds values instead.
+ *
+ * It converts to pair of values and compares with any pair, unlike
+ * std::pair of references, which compares only with pairs of the very same
+ * types.
+ */
+template<class First, class Second>
+class reference_pair : public std::pair<First, Second> {
+public:
+	using base_t = std::pair<First, Second>;
+
+	reference_pair(First firstValue, Second secondValue) :
+		base_t(std::forward<First>(firstValue), std::forward<Second>(secondValue)) {}
+};
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator==(
+	const reference_pair<First1, Second1> &lhs,
+	const reference_pair<First2, Second2> &rhs
+){
+	return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator==(const reference_pair<First1, Second1> &lhs, const std::pair<First2, Second2> &rhs){
+	return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator==(const std::pair<First1, Second1> &lhs, const reference_pair<First2, Second2> &rhs){
+	return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator!=(
+	const reference_pair<First1, Second1> &lhs,
+	const reference_pair<First2, Second2> &rhs
+){
+	return !(lhs == rhs);
+}
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator!=(const reference_pair<First1, Second1> &lhs, const std::pair<First2, Second2> &rhs){
+	return !(lhs == rhs);
+}
+
+template<class First1, class Second1, class First2, class Second2>
+bool
+operator!=(const std::pair<First1, Second1> &lhs, const reference_pair<First2, Second2> &rhs){
+	return !(lhs == rhs);
+}
+
+}
+}
@@ -0,0 +1,705 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "index_iterator.hpp"
+#include "iterator_base.hpp"
+#include "parallel_reduce.hpp"
+#include "radix_sort.hpp"
+
+#include "../meta/helpers.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../executor/executor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Replaces content of buffer with elements of [first, last), reserving memory
+ * up front when the number of elements is known.
+ */
+template<class Iterator, class Buffer>
+void
+gather(Iterator first, Iterator last, const meta::size_hint &hint, Buffer &buffer) {
+	if (hint.is_exact()) {
+		buffer.clear();
+		buffer.reserve(hint.value);
+		std::copy(first, last, std::back_inserter(buffer));
+	} else {
+		buffer.assign(first, last);
+	}
+}
+
+template<class ValueType, class Comparison, class Allocator = default_allocator>
+class contiguous_sort_engine {
+public:
+	using sorted_t = std::vector<ValueType, rebind_alloc_t<Allocator, ValueType>>;
+	using iterator = index_iterator<sorted_t>;
+	using const_iterator = iterator;
+
+	template<class T, class Policy>
+	contiguous_sort_engine(T &&comparison, const Policy &policy) :
+		m_comparison(std::forward<T>(comparison)),
+		m_sorted(typename sorted_t::allocator_type(policy.allocator)) {}
+
+	Allocator
+	get_allocator() const {
+		const Allocator allocator(m_sorted.get_allocator());
+		return allocator;
+	}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		gather(first, last, hint, m_sorted);
+		std::stable_sort(std::begin(m_sorted), std::end(m_sorted), m_comparison);
+	}
+
+	const Comparison &
+	comparison() const {
+		return m_comparison;
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator::begin(&m_sorted);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator::end(&m_sorted);
+	}
+
+private:
+	Comparison m_comparison;
+	sorted_t m_sorted;
+};
+
+/**
+ * Engine gathering elements into contiguous buffer like contiguous_sort_engine,
+ * but sorting it on an executor: the buffer is split into chunks which are
+ * stable sorted concurrently, and then sorted chunks are merged pairwise in
+ * log2(chunks) rounds, merges of each round running concurrently. Both steps
+ * are stable, so the result is the same as of std::stable_sort.
+ */
+template<class ValueType, class Comparison, class Allocator = default_allocator>
+class parallel_sort_engine {
+public:
+	using sorted_t = std::vector<ValueType, rebind_alloc_t<Allocator, ValueType>>;
+	using iterator = index_iterator<sorted_t>;
+	using const_iterator = iterator;
+
+	template<class T, class Policy>
+	parallel_sort_engine(T &&comparison, const Policy &policy) :
+		m_comparison(std::forward<T>(comparison)),
+		m_executor(policy.chunkExecutor),
+		m_concurrency(policy.concurrency),
+		m_sorted(typename sorted_t::allocator_type(policy.allocator)) {}
+
+	Allocator
+	get_allocator() const {
+		const Allocator allocator(m_sorted.get_allocator());
+		return allocator;
+	}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		gather(first, last, hint, m_sorted);
+
+		const std::size_t chunks = std::max<std::size_t>(
+			std::min<std::size_t>(
+				m_concurrency,
+				m_sorted.size() / static_cast<std::size_t>(min_chunk_length)
+			),
+			1
+		);
+		const auto chunkBegin = [this, chunks](std::size_t chunk) {
+			return std::begin(m_sorted) + static_cast<std::ptrdiff_t>(m_sorted.size() * chunk / chunks);
+		};
+
+		m_executor->parallel_for(0, chunks, 1, [this, &chunkBegin](std::size_t chunkFirst, std::size_t chunkLast) {
+			for (; chunkFirst != chunkLast; ++chunkFirst)
+				std::stable_sort(chunkBegin(chunkFirst), chunkBegin(chunkFirst + 1), m_comparison);
+		});
+
+		for (std::size_t width = 1; width < chunks; width *= 2) {
+			const std::size_t merges = (chunks - width + 2 * width - 1) / (2 * width);
+			m_executor->parallel_for(0, merges, 1, [this, &chunkBegin, chunks, width](std::size_t mergeFirst, std::size_t mergeLast) {
+				for (; mergeFirst != mergeLast; ++mergeFirst) {
+					const std::size_t left = mergeFirst * 2 * width;
+					std::inplace_merge(
+						chunkBegin(left),
+						chunkBegin(left + width),
+						chunkBegin(std::min(left + 2 * width, chunks)),
+						m_comparison
+					);
+				}
+			});
+		}
+	}
+
+	const Comparison &
+	comparison() const {
+		return m_comparison;
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator::begin(&m_sorted);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator::end(&m_sorted);
+	}
+
+private:
+	Comparison m_comparison;
+	executor *m_executor;
+	unsigned m_concurrency;
+	sorted_t m_sorted;
+};
+
+/**
+ * Reorders buffer so that element at position i is the one which was at
+ * position order[i].
+ */
+template<class Buffer, class Order>
+void
+permute(Buffer &buffer, const Order &order) {
+	Buffer permuted(buffer.get_allocator());
+	permuted.reserve(buffer.size());
+	for (const std::size_t index : order)
+		permuted.push_back(std::move(buffer[index]));
+	buffer.swap(permuted);
+}
+
+/**
+ * Stable sorts buffer by keys computed with projection, calling projection
+ * once per element: (key, position) pairs are sorted and then the buffer is
+ * permuted accordingly (decorate-sort-undecorate). Pairs and positions are
+ * allocated with allocator of the buffer.
+ */
+template<class Buffer, class Projection, class KeyComparison>
+void
+sort_decorated(Buffer &buffer, const Projection &projection, const KeyComparison &keyComparison) {
+	using key_t = typename std::decay<decltype(projection(buffer.front()))>::type;
+	using decorated_t = std::pair<key_t, std::size_t>;
+	using allocator_t = typename Buffer::allocator_type;
+
+	std::vector<decorated_t, rebind_alloc_t<allocator_t, decorated_t>> decorated(
+		rebind_alloc_t<allocator_t, decorated_t>(buffer.get_allocator())
+	);
+	decorated.reserve(buffer.size());
+	for (std::size_t index = 0; index != buffer.size(); ++index)
+		decorated.emplace_back(projection(buffer[index]), index);
+
+	std::stable_sort(
+		std::begin(decorated),
+		std::end(decorated),
+		[&keyComparison](const decorated_t &a, const decorated_t &b) {
+			return keyComparison(a.first, b.first);
+		}
+	);
+
+	std::vector<std::size_t, rebind_alloc_t<allocator_t, std::size_t>> order(
+		rebind_alloc_t<allocator_t, std::size_t>(buffer.get_allocator())
+	);
+	order.reserve(decorated.size());
+	for (const auto &element : decorated)
+		order.push_back(element.second);
+	permute(buffer, order);
+}
+
+/**
+ * Engine sorting contiguous buffer by keys computed by projection of
+ * key_comparison, evaluating the projection once per element.
+ *
+ * If AllowRadix is true and keys are integers or floating point numbers
+ * compared with `<` or `>`, buffer is ordered with LSD radix sort in O(N * w)
+ * time, where w is width of the key in bytes. Otherwise keys are sorted with
+ * stable comparison sort (see sort_decorated). Both ways keep order of
+ * elements with equal keys.
+ */
+template<class ValueType, class Comparison, bool AllowRadix, class Allocator = default_allocator>
+class projected_sort_engine {
+public:
+	using sorted_t = std::vector<ValueType, rebind_alloc_t<Allocator, ValueType>>;
+	using iterator = index_iterator<sorted_t>;
+	using const_iterator = iterator;
+
+	template<class T, class Policy>
+	projected_sort_engine(T &&comparison, const Policy &policy) :
+		m_comparison(std::forward<T>(comparison)),
+		m_sorted(typename sorted_t::allocator_type(policy.allocator)) {}
+
+	Allocator
+	get_allocator() const {
+		const Allocator allocator(m_sorted.get_allocator());
+		return allocator;
+	}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		gather(first, last, hint, m_sorted);
+		sort_gathered(uses_radix());
+	}
+
+	const Comparison &
+	comparison() const {
+		return m_comparison;
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator::begin(&m_sorted);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator::end(&m_sorted);
+	}
+
+private:
+	using comparison_t = typename std::decay<Comparison>::type;
+	using key_t = typename std::decay<decltype(
+		std::declval<const comparison_t &>().projection()(std::declval<const ValueType &>())
+	)>::type;
+	using direction_t = radix_direction<
+		typename std::decay<decltype(std::declval<const comparison_t &>().key_comparator())>::type,
+		key_t
+	>;
+	using uses_radix = std::integral_constant<
+		bool,
+		AllowRadix && is_radix_key<key_t>::value && direction_t::is_known
+	>;
+
+	//! Below this size comparison sort is faster than radix sort.
+	static const std::size_t min_radix_size = 64;
+
+	void
+	sort_gathered(std::false_type) {
+		sort_decorated(m_sorted, m_comparison.projection(), m_comparison.key_comparator());
+	}
+
+	void
+	sort_gathered(std::true_type) {
+		if (m_sorted.size() < min_radix_size) {
+			sort_gathered(std::false_type());
+			return;
+		}
+
+		using code_t = radix_unsigned_t<key_t>;
+		std::vector<code_t, rebind_alloc_t<Allocator, code_t>> codes(
+			rebind_alloc_t<Allocator, code_t>(m_sorted.get_allocator())
+		);
+		codes.reserve(m_sorted.size());
+		for (const auto &value : m_sorted) {
+			code_t code = radix_encode<key_t>(m_comparison.projection()(value));
+			if (direction_t::is_descending)
+				code = ~code;
+			codes.push_back(code);
+		}
+
+		permute(m_sorted, radix_order(codes));
+	}
+
+	Comparison m_comparison;
+	sorted_t m_sorted;
+};
+
+/**
+ * Forward iterator over elements of lazy_sort_engine. Dereferencing it makes
+ * the engine extract elements from the heap up to the pointed one.
+ */
+template<class Engine>
+class lazy_sort_iterator : public input_iterator_base<lazy_sort_iterator<Engine>> {
+public:
+	using value_type = typename Engine::value_type;
+	using difference_type = std::ptrdiff_t;
+	using reference = const value_type &;
+	using pointer = const value_type *;
+	using iterator_category = std::forward_iterator_tag;
+
+	lazy_sort_iterator() = default;
+
+	~lazy_sort_iterator() noexcept = default;
+
+	lazy_sort_iterator(
+		const Engine *engine,
+		std::size_t index
+	) :
+		m_engine(engine),
+		m_index(index) {}
+
+	lazy_sort_iterator &
+	next() {
+		++m_index;
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		return m_engine->element(m_index);
+	}
+
+	pointer
+	operator->() const {
+		return &m_engine->element(m_index);
+	}
+
+	bool
+	operator==(const lazy_sort_iterator &other) const {
+		const bool isEnd = is_end();
+		const bool isOtherEnd = other.is_end();
+		return (isEnd && isOtherEnd) || (!isEnd && !isOtherEnd && m_index == other.m_index);
+	}
+
+private:
+	// Default constructed iterator belongs to no engine and is at the end.
+	bool
+	is_end() const {
+		return m_engine == nullptr || m_index >= m_engine->size();
+	}
+
+	const Engine *m_engine = nullptr;
+	std::size_t m_index = 0;
+};
+
+/**
+ * Engine which only heapifies the input, in O(N) time, and extracts elements
+ * from the heap in O(log(N)) time each, as they are reached by iterators. So
+ * cost of sorting depends on number of elements actually consumed. Elements
+ * are paired with their position in the input to keep order of equivalent
+ * elements the same as stable sort.
+ *
+ * Extracted elements are stored at the back of the buffer, in reverse order,
+ * while the heap shrinks at its front.
+ */
+template<class ValueType, class Comparison, class Allocator = default_allocator>
+class lazy_sort_engine {
+	using indexed_t = std::pair<ValueType, std::size_t>;
+	using buffer_t = std::vector<indexed_t, rebind_alloc_t<Allocator, indexed_t>>;
+
+public:
+	using value_type = ValueType;
+	using iterator = lazy_sort_iterator<lazy_sort_engine>;
+	using const_iterator = iterator;
+
+	template<class T, class Policy>
+	lazy_sort_engine(T &&comparison, const Policy &policy) :
+		m_comparison(std::forward<T>(comparison)),
+		m_buffer(typename buffer_t::allocator_type(policy.allocator)),
+		m_heapSize(0) {}
+
+	Allocator
+	get_allocator() const {
+		const Allocator allocator(m_buffer.get_allocator());
+		return allocator;
+	}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		m_buffer.clear();
+		if (hint.is_exact())
+			m_buffer.reserve(hint.value);
+		for (std::size_t index = 0; first != last; ++first, ++index)
+			m_buffer.emplace_back(*first, index);
+
+		std::make_heap(std::begin(m_buffer), std::end(m_buffer), later());
+		m_heapSize = m_buffer.size();
+	}
+
+	const Comparison &
+	comparison() const {
+		return m_comparison;
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator(this, 0);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator(this, std::numeric_limits<std::size_t>::max());
+	}
+
+	std::size_t
+	size() const {
+		return m_buffer.size();
+	}
+
+	//! Returns element at given position in sorted order.
+	const ValueType &
+	element(std::size_t index) const {
+		while (m_buffer.size() - m_heapSize <= index) {
+			std::pop_heap(
+				std::begin(m_buffer),
+				std::begin(m_buffer) + static_cast<std::ptrdiff_t>(m_heapSize),
+				later()
+			);
+			--m_heapSize;
+		}
+		return m_buffer[m_buffer.size() - 1 - index].first;
+	}
+
+private:
+	// Heap ordering placing element which comes first in sorted order on top.
+	auto
+	later() const {
+		return [this](const indexed_t &a, const indexed_t &b) {
+			return m_comparison(b.first, a.first) ||
+				(!m_comparison(a.first, b.first) && b.second < a.second);
+		};
+	}
+
+	Comparison m_comparison;
+	// Heap and extracted elements change when iterators are dereferenced.
+	mutable buffer_t m_buffer;
+	mutable std::size_t m_heapSize;
+};
+
+template<class ValueType, class Comparison, class Allocator = default_allocator>
+class multiset_sort_engine {
+public:
+	using sorted_t = std::multiset<
+		ValueType,
+		Comparison,
+		rebind_alloc_t<Allocator, ValueType>
+	>;
+	using iterator = typename sorted_t::iterator;
+	using const_iterator = typename sorted_t::const_iterator;
+
+	template<class T, class Policy>
+	multiset_sort_engine(T &&comparison, const Policy &policy) :
+		m_sorted(
+			std::forward<T>(comparison),
+			typename sorted_t::allocator_type(policy.allocator)
+		) {}
+
+	Allocator
+	get_allocator() const {
+		const Allocator allocator(m_sorted.get_allocator());
+		return allocator;
+	}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &) {
+		m_sorted.clear();
+		m_sorted.insert(first, last);
+	}
+
+	Comparison
+	comparison() const {
+		return m_sorted.key_comp();
+	}
+
+	iterator
+	begin() {
+		return std::begin(m_sorted);
+	}
+
+	iterator
+	end() {
+		return std::end(m_sorted);
+	}
+
+	const_iterator
+	begin() const {
+		return std::begin(m_sorted);
+	}
+
+	const_iterator
+	end() const {
+		return std::end(m_sorted);
+	}
+
+private:
+	sorted_t m_sorted;
+};
+
+/**
+ * Allocator of sort engine, which bounded_sort_engine created from it uses.
+ * Engines which do not expose one, like external_sort_engine, give
+ * default_allocator.
+ */
+template<class Engine, class = void>
+struct engine_allocator {
+	using type = default_allocator;
+
+	static type
+	get(const Engine &) {
+		return type();
+	}
+};
+
+template<class Engine>
+struct engine_allocator<
+	Engine,
+	typename meta::type_sink<decltype(std::declval<const Engine &>().get_allocator())>::type
+> {
+	using type = decltype(std::declval<const Engine &>().get_allocator());
+
+	static type
+	get(const Engine &engine) {
+		return engine.get_allocator();
+	}
+};
+
+/**
+ * Keys by which bounded_sort_engine orders elements. Elements are their own
+ * keys, compared with the comparison itself.
+ */
+template<class ValueType, class Comparison, class = void>
+struct bounded_sort_keys {
+	struct key_type {};
+
+	static key_type
+	key_of(const Comparison &, const ValueType &) {
+		return key_type();
+	}
+
+	static bool
+	less(
+		const Comparison &comparison,
+		const ValueType &a, const key_type &,
+		const ValueType &b, const key_type &
+	) {
+		return comparison(a, b);
+	}
+};
+
+/**
+ * Keys of key_comparison are computed by its projection once per element and
+ * stored next to the element, so that heap operations do not project again.
+ */
+template<class ValueType, class Comparison>
+struct bounded_sort_keys<
+	ValueType,
+	Comparison,
+	typename meta::type_sink<decltype(std::declval<const Comparison &>().projection())>::type
+> {
+	using key_type = typename std::decay<decltype(
+		std::declval<const Comparison &>().projection()(std::declval<const ValueType &>())
+	)>::type;
+
+	static key_type
+	key_of(const Comparison &comparison, const ValueType &value) {
+		return comparison.projection()(value);
+	}
+
+	static bool
+	less(
+		const Comparison &comparison,
+		const ValueType &, const key_type &a,
+		const ValueType &, const key_type &b
+	) {
+		return comparison.key_comparator()(a, b);
+	}
+};
+
+/**
+ * Engine keeping only first `toTake` elements of the sorted order. Input is
+ * scanned once while maintaining bounded max-heap, so sorting takes
+ * O(N log(k)) time and O(k) memory. Elements are paired with their position in
+ * the input to keep order of equivalent elements the same as stable sort.
+ * Both the heap and the result are allocated with given allocator.
+ */
+template<class ValueType, class Comparison, class Allocator = default_allocator>
+class bounded_sort_engine {
+public:
+	using sorted_t = std::vector<ValueType, rebind_alloc_t<Allocator, ValueType>>;
+	using iterator = index_iterator<sorted_t>;
+	using const_iterator = iterator;
+
+	template<class T>
+	bounded_sort_engine(T &&comparison, unsigned toTake, const Allocator &allocator = Allocator()) :
+		m_comparison(std::forward<T>(comparison)),
+		m_toTake(toTake),
+		m_sorted(typename sorted_t::allocator_type(allocator)) {}
+
+	template<class Iterator>
+	void
+	sort(Iterator first, Iterator last, const meta::size_hint &hint) {
+		using keys_t = bounded_sort_keys<ValueType, typename std::decay<Comparison>::type>;
+		using key_t = typename keys_t::key_type;
+		struct entry {
+			key_t key;
+			ValueType value;
+			std::size_t index;
+		};
+		const auto entryLess = [this](const entry &a, const entry &b) {
+			return keys_t::less(m_comparison, a.value, a.key, b.value, b.key) ||
+				(!keys_t::less(m_comparison, b.value, b.key, a.value, a.key) && a.index < b.index);
+		};
+
+		std::vector<entry, rebind_alloc_t<Allocator, entry>> heap(
+			rebind_alloc_t<Allocator, entry>(m_sorted.get_allocator())
+		);
+		m_sorted.clear();
+		if (m_toTake == 0)
+			return;
+
+		// Memory for k elements is reserved only if the input is known to
+		// have them, as k may be far greater than the input.
+		if (hint.is_bounded())
+			heap.reserve(std::min<std::size_t>(hint.value, m_toTake));
+
+		std::size_t index = 0;
+		for (; first != last; ++first, ++index) {
+			// Each element is read once, as reading it again may compute it
+			// again, e.g. after transform.
+			auto &&value = *first;
+			key_t key = keys_t::key_of(m_comparison, value);
+			if (heap.size() < m_toTake) {
+				heap.push_back(entry{ std::move(key), std::forward<decltype(value)>(value), index });
+				std::push_heap(std::begin(heap), std::end(heap), entryLess);
+			} else if (keys_t::less(m_comparison, value, key, heap.front().value, heap.front().key)) {
+				std::pop_heap(std::begin(heap), std::end(heap), entryLess);
+				heap.back() = entry{ std::move(key), std::forward<decltype(value)>(value), index };
+				std::push_heap(std::begin(heap), std::end(heap), entryLess);
+			}
+		}
+
+		std::sort_heap(std::begin(heap), std::end(heap), entryLess);
+		m_sorted.reserve(heap.size());
+		for (auto &element : heap)
+			m_sorted.push_back(std::move(element.value));
+	}
+
+	unsigned
+	to_take() const {
+		return m_toTake;
+	}
+
+	const_iterator
+	begin() const {
+		return const_iterator::begin(&m_sorted);
+	}
+
+	const_iterator
+	end() const {
+		return const_iterator::end(&m_sorted);
+	}
+
+private:
+	Comparison m_comparison;
+	unsigned m_toTake;
+	sorted_t m_sorted;
+};
+
+}
+}
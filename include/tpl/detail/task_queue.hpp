@@ -0,0 +1,52 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace tpl{
+namespace detail{
+
+/**
+ * Double ended queue of tasks owned by one worker of an executor. Owner pushes
+ * and pops tasks at the back, so recently forked (and usually smallest) tasks
+ * are run first, while other threads steal the oldest tasks from the front.
+ */
+class task_queue {
+public:
+	using task_t = std::function<void()>;
+
+	void
+	push_back(task_t task) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+
+	bool
+	pop_back(task_t &task) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_tasks.empty())
+			return false;
+		task = std::move(m_tasks.back());
+		m_tasks.pop_back();
+		return true;
+	}
+
+	bool
+	pop_front(task_t &task) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_tasks.empty())
+			return false;
+		task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::deque<task_t> m_tasks;
+};
+
+}
+}
@@ -0,0 +1,258 @@
+/**
+ * \file
+ * \brief File defining work-stealing thread pool used by parallel parts of
+ *     the library.
+ */
+#pragma once
+
+#include "../detail/task_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tpl{
+
+/**
+ * \brief Work-stealing thread pool.
+ *
+ * Each worker owns a queue of tasks. Tasks forked by a worker are pushed to
+ * its own queue and idle workers steal the oldest tasks from queues of other
+ * workers, so recursive fork/join computations spread over all workers
+ * without a shared queue becoming the bottleneck.
+ *
+ * Threads waiting for forked tasks (including threads which are not workers
+ * of the executor) run queued tasks instead of blocking, thus nested parallel
+ * computations never deadlock, and executor with no workers runs everything
+ * on calling thread.
+ *
+ * Executor is neither copyable nor movable. Destructor waits until all queued
+ * tasks are finished.
+ */
+class executor {
+public:
+	/**
+	 * \brief Creates executor and starts its workers.
+	 *
+	 * \param workerCount Number of worker threads.
+	 */
+	explicit executor(unsigned workerCount) :
+		m_queues(),
+		m_workers(),
+		m_pending(0),
+		m_nextQueue(0),
+		m_isStopping(false) {
+		m_queues.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i)
+			m_queues.push_back(std::make_unique<detail::task_queue>());
+
+		m_workers.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i)
+			m_workers.emplace_back([this, i]() { work(i); });
+	}
+
+	executor(const executor &) = delete;
+
+	executor &
+	operator=(const executor &) = delete;
+
+	~executor() noexcept {
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_isStopping = true;
+		}
+		m_wakeUp.notify_all();
+		for (auto &worker : m_workers)
+			worker.join();
+	}
+
+	/**
+	 * \brief Returns number of worker threads.
+	 */
+	unsigned
+	worker_count() const {
+		return static_cast<unsigned>(m_workers.size());
+	}
+
+	/**
+	 * \brief Runs both functions, possibly concurrently, and returns when
+	 *     both are finished.
+	 *
+	 * `right` is queued, so it can be stolen by idle worker, and `left` is run
+	 * on calling thread. If `right` is not stolen until `left` finishes, it is
+	 * run on calling thread as well. Exceptions thrown by any of functions are
+	 * rethrown after both of them finish.
+	 */
+	template<class Left, class Right>
+	void
+	fork_join(Left &&left, Right &&right) {
+		if (m_workers.empty()) {
+			left();
+			right();
+			return;
+		}
+
+		std::atomic<bool> isRightDone(false);
+		std::exception_ptr rightError;
+		push([&right, &isRightDone, &rightError]() {
+			try {
+				right();
+			} catch (...) {
+				rightError = std::current_exception();
+			}
+			isRightDone.store(true, std::memory_order_release);
+		});
+
+		std::exception_ptr leftError;
+		try {
+			left();
+		} catch (...) {
+			leftError = std::current_exception();
+		}
+
+		while (!isRightDone.load(std::memory_order_acquire))
+			if (!run_one())
+				std::this_thread::yield();
+
+		if (leftError)
+			std::rethrow_exception(leftError);
+		if (rightError)
+			std::rethrow_exception(rightError);
+	}
+
+	/**
+	 * \brief Calls `function(chunkFirst, chunkLast)` for disjoint subranges
+	 *     covering [first, last), each having at most `grain` indices.
+	 *
+	 * Range is split in halves recursively with fork_join, so subranges are
+	 * processed concurrently.
+	 *
+	 * **Complexity**
+	 * O((last - first) / grain) calls of function.
+	 */
+	template<class Function>
+	void
+	parallel_for(std::size_t first, std::size_t last, std::size_t grain, Function &&function) {
+		grain = std::max<std::size_t>(grain, 1);
+		if (last - first <= grain) {
+			if (first != last)
+				function(first, last);
+			return;
+		}
+
+		const std::size_t middle = first + (last - first) / 2;
+		fork_join(
+			[this, first, middle, grain, &function]() {
+				parallel_for(first, middle, grain, function);
+			},
+			[this, middle, last, grain, &function]() {
+				parallel_for(middle, last, grain, function);
+			}
+		);
+	}
+
+private:
+	using task_t = detail::task_queue::task_t;
+
+	struct worker_context {
+		const executor *owner;
+		std::size_t index;
+	};
+
+	static worker_context &
+	current_worker() {
+		static thread_local worker_context context{ nullptr, 0 };
+		return context;
+	}
+
+	void
+	push(task_t task) {
+		const worker_context &context = current_worker();
+		const std::size_t index = context.owner == this ?
+			context.index :
+			m_nextQueue++ % m_queues.size();
+
+		m_queues[index]->push_back(std::move(task));
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			++m_pending;
+		}
+		m_wakeUp.notify_one();
+	}
+
+	bool
+	pop(task_t &task) {
+		const worker_context &context = current_worker();
+		std::size_t first = 0;
+		if (context.owner == this) {
+			if (m_queues[context.index]->pop_back(task)) {
+				--m_pending;
+				return true;
+			}
+			first = context.index + 1;
+		}
+
+		for (std::size_t i = 0; i < m_queues.size(); ++i) {
+			if (m_queues[(first + i) % m_queues.size()]->pop_front(task)) {
+				--m_pending;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool
+	run_one() {
+		task_t task;
+		if (!pop(task))
+			return false;
+		task();
+		return true;
+	}
+
+	void
+	work(std::size_t index) {
+		current_worker() = worker_context{ this, index };
+		while (true) {
+			if (run_one())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeUp.wait(lock, [this]() { return m_isStopping || m_pending > 0; });
+			if (m_isStopping && m_pending <= 0)
+				return;
+		}
+	}
+
+	std::vector<std::unique_ptr<detail::task_queue>> m_queues;
+	std::vector<std::thread> m_workers;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeUp;
+	std::atomic<std::ptrdiff_t> m_pending;
+	std::atomic<std::size_t> m_nextQueue;
+	bool m_isStopping;
+};
+
+/**
+ * \brief Returns executor shared by parallel operations of the library which
+ *     were not given executor explicitly.
+ *
+ * The executor is created on first use with one worker less than number of
+ * hardware threads, as the calling thread takes part in computations too.
+ */
+inline executor &
+default_executor() {
+	static executor instance(
+		std::max(std::thread::hardware_concurrency(), 1u) - 1
+	);
+	return instance;
+}
+
+}
@@ -6,10 +6,13 @@
 
 #include "../meta/is_enumerable.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
 
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include <algorithm>
+#include <iterator>
 
 namespace tpl{
 
@@ -30,8 +33,9 @@ public:
 	cycle_iterator(
 		Enumerable &&enumerable
 	) :
-		m_enumerable(std::forward<Enumerable>(enumerable)),
-   		m_currentIterator(enumerable.begin()) {}
+		m_enumerable(std::forward<Enumerable>(enumerable)) {
+		m_currentIterator = m_enumerable.begin();
+	}
 
 	cycle_iterator &
 	operator++() {
@@ -133,6 +137,28 @@ public:
 		return iterator(m_enumerable);
 	}
 
+	/**
+	 * \brief Pushes elements of repeated sequence to given callback until it
+	 *     returns false.
+	 *
+	 * \return true if repeated sequence is empty, false otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		if (std::begin(m_enumerable) == std::end(m_enumerable))
+			return true;
+
+		while (detail::for_each(m_enumerable, callback)) {}
+		return false;
+	}
+
+	//! Returns size hint, which is always infinite.
+	meta::size_hint
+	size_hint() const {
+		return meta::size_hint::infinite();
+	}
+
 private:
 	Enumerable m_enumerable;
 };
@@ -4,9 +4,13 @@
  */
 #pragma once
 
+#include "../meta/size_hint.hpp"
+
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include <algorithm>
+#include <type_traits>
 
 namespace tpl{
 
@@ -121,6 +125,30 @@ public:
 	end() const {
 		return iterator(m_generatingFunction, m_initialValue);
 	}
+
+	/**
+	 * \brief Pushes generated elements to given callback until it returns
+	 *     false.
+	 *
+	 * \return Always false, as the sequence is infinite.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		for (
+			typename std::decay<ValueType>::type value = m_initialValue;
+			detail::invoke_callback(callback, value);
+			value = m_generatingFunction(value)
+		) {}
+		return false;
+	}
+
+	//! Returns size hint, which is always infinite.
+	meta::size_hint
+	size_hint() const {
+		return meta::size_hint::infinite();
+	}
+
 private:
 	GeneratingFunction m_generatingFunction;
 	ValueType m_initialValue;
@@ -4,7 +4,10 @@
  */
 #pragma once
 
+#include "../meta/size_hint.hpp"
+
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include <algorithm>
 
@@ -107,6 +110,25 @@ public:
 	end() const {
 		return iterator(m_value);
 	}
+
+	/**
+	 * \brief Pushes the value to given callback until it returns false.
+	 *
+	 * \return Always false, as the sequence is infinite.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		while (detail::invoke_callback(callback, m_value)) {}
+		return false;
+	}
+
+	//! Returns size hint, which is always infinite.
+	meta::size_hint
+	size_hint() const {
+		return meta::size_hint::infinite();
+	}
+
 private:
 	value_type m_value;
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "helpers.hpp"
+
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+namespace meta{
+
+//! Callback accepting any element, used only to detect for_each member.
+struct for_each_probe {
+	template<class T>
+	bool operator()(T &&) const { return true; }
+};
+
+/**
+ * \brief Checks if T implements push-based iteration, i.e. has const member
+ *     function `bool for_each(Callback &&)`.
+ */
+template<class T, class = void>
+struct has_for_each : std::false_type {};
+
+template<class T>
+struct has_for_each<
+	T,
+	typename type_sink<
+		decltype(std::declval<const typename std::decay<T>::type &>().for_each(
+			std::declval<for_each_probe &>()
+		))
+	>::type
+> : std::true_type {};
+
+}
+}
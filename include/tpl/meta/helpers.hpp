@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 namespace tpl {
 namespace meta {
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <type_traits>
+
+namespace tpl{
+
+template<class Enumerable>
+class parallel_sequence;
+
+namespace meta{
+
+/**
+ * \brief Checks if T is a sequence marked with tpl::par, i.e. sinks consuming
+ *     it are allowed to process its elements on many threads.
+ */
+template<class T>
+struct is_parallel : std::false_type {};
+
+template<class Enumerable>
+struct is_parallel<parallel_sequence<Enumerable>> : std::true_type {};
+
+template<class T>
+struct is_parallel<const T> : is_parallel<T> {};
+
+template<class T>
+struct is_parallel<T &> : is_parallel<T> {};
+
+template<class T>
+struct is_parallel<T &&> : is_parallel<T> {};
+
+}
+}
@@ -44,6 +44,13 @@ using demote_to_bidirectional_tag = std::conditional<
 	typename T::iterator_category
 >;
 
+template<class T>
+using demote_to_forward_tag = std::conditional<
+	is_random_access_iterator<T>::value || is_bidirectional_iterator<T>::value,
+	std::forward_iterator_tag,
+	typename T::iterator_category
+>;
+
 template<class T>
 struct type_wrapper{
 	using type = T;	
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "../common/materialization.hpp"
+
+#include <type_traits>
+
+namespace tpl{
+
+template<class Enumerable, class Comparison, class Policy, class Materialization>
+class sorted_sequence;
+
+template<class Enumerable, class Comparison, class Materialization, class Allocator>
+class partially_sorted_sequence;
+
+template<class Enumerable, class Grouping, class Materialization, class Backend>
+class grouped_sequence;
+
+template<
+	class Enumerable,
+	class KeyFunction,
+	class InitialValue,
+	class Combine,
+	class Materialization,
+	class Backend
+>
+class aggregated_sequence;
+
+template<class Enumerable, class Predicate>
+class transformed_sequence;
+
+template<class Enumerable, class FilterPredicate>
+class filtered_sequence;
+
+template<class Enumerable>
+class dropping_sequence;
+
+template<class Enumerable>
+class taken_sequence;
+
+template<class Enumerable>
+class reversing_sequence;
+
+template<class Enumerable>
+class flattened_sequence;
+
+template<class Enumerable>
+class keys_sequence;
+
+template<class Enumerable>
+class mapped_values_sequence;
+
+template<class Enumerable, class KeyFunction>
+class chunked_sequence;
+
+template<class Enumerable>
+class no_operation_sequence;
+
+template<class Enumerable>
+class parallel_sequence;
+
+template<class Enumerable1, class Enumerable2>
+class ziped_sequence;
+
+namespace meta{
+
+/**
+ * \brief Checks if begin() of T rebuilds the storage its iterators point
+ *     into, like the one of sorted or grouped sequence in rebuild_on_begin_t
+ *     mode, either directly or through wrapped sequences.
+ *
+ * Iterators of such sequences are invalidated by any later begin() call, so
+ * they must not be cached by stages wrapping them.
+ */
+template<class T>
+struct rebuilds_on_begin : std::false_type {};
+
+template<class T>
+struct rebuilds_on_begin<const T> : rebuilds_on_begin<T> {};
+
+template<class T>
+struct rebuilds_on_begin<T &> : rebuilds_on_begin<T> {};
+
+template<class T>
+struct rebuilds_on_begin<T &&> : rebuilds_on_begin<T> {};
+
+template<class Materialization>
+using is_rebuilt_on_begin = std::is_same<Materialization, rebuild_on_begin_t>;
+
+template<class E, class C, class P, class M>
+struct rebuilds_on_begin<sorted_sequence<E, C, P, M>> :
+	std::integral_constant<bool, is_rebuilt_on_begin<M>::value || rebuilds_on_begin<E>::value> {};
+
+template<class E, class C, class M, class A>
+struct rebuilds_on_begin<partially_sorted_sequence<E, C, M, A>> :
+	std::integral_constant<bool, is_rebuilt_on_begin<M>::value || rebuilds_on_begin<E>::value> {};
+
+template<class E, class G, class M, class B>
+struct rebuilds_on_begin<grouped_sequence<E, G, M, B>> :
+	std::integral_constant<bool, is_rebuilt_on_begin<M>::value || rebuilds_on_begin<E>::value> {};
+
+template<class E, class K, class I, class C, class M, class B>
+struct rebuilds_on_begin<aggregated_sequence<E, K, I, C, M, B>> :
+	std::integral_constant<bool, is_rebuilt_on_begin<M>::value || rebuilds_on_begin<E>::value> {};
+
+template<class E, class P>
+struct rebuilds_on_begin<transformed_sequence<E, P>> : rebuilds_on_begin<E> {};
+
+template<class E, class P>
+struct rebuilds_on_begin<filtered_sequence<E, P>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<dropping_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<taken_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<reversing_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<flattened_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<keys_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<mapped_values_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E, class K>
+struct rebuilds_on_begin<chunked_sequence<E, K>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<no_operation_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E>
+struct rebuilds_on_begin<parallel_sequence<E>> : rebuilds_on_begin<E> {};
+
+template<class E1, class E2>
+struct rebuilds_on_begin<ziped_sequence<E1, E2>> :
+	std::integral_constant<bool, rebuilds_on_begin<E1>::value || rebuilds_on_begin<E2>::value> {};
+
+}
+}
@@ -0,0 +1,218 @@
+/**
+ * \file
+ * \brief File defining size hints, which describe number of elements in
+ *     a sequence without iterating over it.
+ */
+#pragma once
+
+#include "helpers.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+namespace meta{
+
+//! Kind of knowledge about number of elements in a sequence.
+enum class size_kind {
+	//! Sequence has exactly size_hint::value elements.
+	exact,
+	//! Sequence has at most size_hint::value elements.
+	upper_bound,
+	//! Number of elements cannot be told without iterating the sequence.
+	unknown,
+	//! Sequence never ends.
+	infinite
+};
+
+/**
+ * \brief Number of elements in a sequence as known before iterating over it.
+ *
+ * Each sequence in tpl exposes size_hint() computed from the hint of the
+ * wrapped sequence, so that stages which materialize elements can reserve
+ * memory up front.
+ */
+struct size_hint {
+	size_kind kind;
+	std::size_t value;
+
+	static size_hint
+	exact(std::size_t count) {
+		return size_hint{ size_kind::exact, count };
+	}
+
+	static size_hint
+	upper_bound(std::size_t count) {
+		return size_hint{ size_kind::upper_bound, count };
+	}
+
+	static size_hint
+	unknown() {
+		return size_hint{ size_kind::unknown, 0 };
+	}
+
+	static size_hint
+	infinite() {
+		return size_hint{ size_kind::infinite, 0 };
+	}
+
+	//! Checks if value is the exact number of elements.
+	bool
+	is_exact() const {
+		return kind == size_kind::exact;
+	}
+
+	//! Checks if value is the exact number or upper bound of number of elements.
+	bool
+	is_bounded() const {
+		return kind == size_kind::exact || kind == size_kind::upper_bound;
+	}
+
+	bool
+	operator==(const size_hint &other) const {
+		return kind == other.kind && value == other.value;
+	}
+
+	bool
+	operator!=(const size_hint &other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * \brief Hint of a sequence consisting of at most `count` first elements of
+ *     sequence described by `hint`.
+ */
+inline size_hint
+take_size_hint(const size_hint &hint, std::size_t count) {
+	switch (hint.kind) {
+	case size_kind::exact:
+		return size_hint::exact(std::min(hint.value, count));
+	case size_kind::upper_bound:
+		return size_hint::upper_bound(std::min(hint.value, count));
+	case size_kind::infinite:
+		return size_hint::exact(count);
+	default:
+		return size_hint::upper_bound(count);
+	}
+}
+
+/**
+ * \brief Hint of a sequence omitting `count` first elements of sequence
+ *     described by `hint`.
+ */
+inline size_hint
+drop_size_hint(const size_hint &hint, std::size_t count) {
+	if (!hint.is_bounded())
+		return hint;
+
+	return size_hint{ hint.kind, hint.value > count ? hint.value - count : 0 };
+}
+
+/**
+ * \brief Hint of a sequence consisting of some of elements of sequence
+ *     described by `hint`, e.g. the filtered one.
+ */
+inline size_hint
+subset_size_hint(const size_hint &hint) {
+	if (hint.is_bounded())
+		return size_hint::upper_bound(hint.value);
+
+	return size_hint::unknown();
+}
+
+/**
+ * \brief Hint of a sequence which ends together with the shorter one of
+ *     sequences described by given hints, e.g. the zipped one.
+ */
+inline size_hint
+min_size_hint(const size_hint &first, const size_hint &second) {
+	if (first.kind == size_kind::infinite)
+		return second;
+	if (second.kind == size_kind::infinite)
+		return first;
+	if (first.is_exact() && second.is_exact())
+		return size_hint::exact(std::min(first.value, second.value));
+	if (first.is_bounded() && second.is_bounded())
+		return size_hint::upper_bound(std::min(first.value, second.value));
+	if (first.is_bounded())
+		return size_hint::upper_bound(first.value);
+	if (second.is_bounded())
+		return size_hint::upper_bound(second.value);
+
+	return size_hint::unknown();
+}
+
+template<class T, class = void>
+struct has_size_hint : std::false_type {};
+
+template<class T>
+struct has_size_hint<
+	T,
+	typename type_sink<
+		decltype(std::declval<const typename std::decay<T>::type &>().size_hint())
+	>::type
+> : std::true_type {};
+
+/**
+ * \brief Checks if number of elements of T can be retrieved in constant time,
+ *     i.e. T is an array or has size() member function.
+ */
+template<class T, class = void>
+struct has_size : std::is_array<typename std::remove_reference<T>::type> {};
+
+template<class T>
+struct has_size<
+	T,
+	typename type_sink<
+		decltype(std::declval<const typename std::decay<T>::type &>().size())
+	>::type
+> : std::true_type {};
+
+template<class T, std::size_t N>
+std::size_t
+get_size(const T (&)[N]) {
+	return N;
+}
+
+template<class T>
+auto
+get_size(const T &enumerable) -> decltype(enumerable.size(), std::size_t()) {
+	return enumerable.size();
+}
+
+/**
+ * \brief Returns size hint of given sequence.
+ *
+ * Result of size_hint() member function is used if the sequence has one.
+ * Otherwise hint is exact for arrays and sequences with size() member function
+ * (e.g. standard containers), and unknown for all other sequences.
+ */
+template<class T>
+typename std::enable_if<has_size_hint<T>::value, size_hint>::type
+get_size_hint(const T &enumerable) {
+	return enumerable.size_hint();
+}
+
+template<class T>
+typename std::enable_if<
+	!has_size_hint<T>::value && has_size<T>::value,
+	size_hint
+>::type
+get_size_hint(const T &enumerable) {
+	return size_hint::exact(get_size(enumerable));
+}
+
+template<class T>
+typename std::enable_if<
+	!has_size_hint<T>::value && !has_size<T>::value,
+	size_hint
+>::type
+get_size_hint(const T &) {
+	return size_hint::unknown();
+}
+
+}
+}
@@ -6,6 +6,8 @@
 #include "operator/flattened.hpp"
 #include "operator/keys.hpp"
 #include "operator/mapped_values.hpp"
+#include "operator/memoized.hpp"
+#include "operator/parallel.hpp"
 #include "operator/sorted.hpp"
 #include "operator/take.hpp"
 #include "operator/transformed.hpp"
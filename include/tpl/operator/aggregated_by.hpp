@@ -0,0 +1,409 @@
+/**
+ * \file
+ * \brief File defining operator which groups given sequence and folds every
+ *     group into single value.
+ */
+#pragma once
+
+#include "grouped_by.hpp"
+
+#include "../meta/is_enumerable.hpp"
+#include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/for_each.hpp"
+
+#include "../common/materialization.hpp"
+#include "../common/composite_factory.hpp"
+#include "../common/apply_operator.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+
+/**
+ * \brief Sequence grouping input sequence by keys computed with given function
+ *     and folding elements of every group into single accumulator.
+ *
+ * Unlike grouped_sequence it does not copy elements into groups - only one
+ * accumulator per distinct key is kept, so memory usage depends on number of
+ * distinct keys instead of number of elements.
+ *
+ * This class cannnot be safely used with infinite sequences - it eagerly
+ * processes the input sequence.
+ *
+ * This class complies with is_enumerable trait, which allows it to be used in
+ * a pipeline.
+ *
+ * \tparam Enumerable Type of sequence which is to be aggregated. Must satisfy
+ *      is_enumerable trait.
+ * \tparam KeyFunction Type of function computing keys of elements. It must
+ *      take one argument constructible from Enumerable::value_type and return
+ *      any copy-constructible type.
+ * \tparam InitialValue Type of initial value of every accumulator.
+ * \tparam Combine Type of function folding elements into accumulator. It must
+ *      take accumulator and element and return value convertible to
+ *      accumulator.
+ * \tparam Materialization Either rebuild_on_begin_t (sequence is aggregated
+ *      on every begin() call) or materialize_once_t (sequence is aggregated on
+ *      first begin() call and then only after refresh()).
+ * \tparam Backend Type of grouping backend, either
+ *      basic_flat_hash_grouping_policy or basic_unordered_map_grouping_policy.
+ */
+template<
+	class Enumerable,
+	class KeyFunction,
+	class InitialValue,
+	class Combine,
+	class Materialization = rebuild_on_begin_t,
+	class Backend = flat_hash_grouping_policy
+>
+class aggregated_sequence :
+	meta::enforce_enumerable<Enumerable> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+
+	/**
+	 * \brief Type of .first value in pair returned from iterators.
+	 *
+	 * This type is the decayed return type of KeyFunction.
+	 */
+	using key_type = typename std::decay<decltype(std::declval<KeyFunction>()(
+		std::declval<typename enumerable_traits::value_type>())
+	)>::type;
+
+	/**
+	 * \brief Type of .second value in pair returned from iterators.
+	 *
+	 * This type is the decayed type of initial value.
+	 */
+	using mapped_type = typename std::decay<InitialValue>::type;
+	using aggregated_t = typename Backend::template table<key_type, mapped_type>;
+
+	//! Type of values returned from dereferencing iterators.
+	using value_type = typename aggregated_t::value_type;
+
+	//! Type of const_iterator.
+	using const_iterator = typename aggregated_t::const_iterator;
+
+	//! Type of iterator.
+	using iterator = typename aggregated_t::iterator;
+
+	/**
+	 * \brief Creates new aggregated_sequence from given sequence.
+	 *
+	 * **Complexity**
+	 * - O(1) for rvalue references of enumerable
+	 * - O(N) for lvalue references of enumerable (where N is size of enumerable)
+	 *
+	 * \param enumerable Sequence which is to be aggregated.
+	 * \param keyFunction Function computing keys of elements.
+	 * \param initialValue Initial value of every accumulator.
+	 * \param combine Function folding elements into accumulators.
+	 * \param backend Grouping backend, whose allocator is used for the table.
+	 */
+	template<class K, class I, class C>
+	aggregated_sequence(
+		Enumerable &&enumerable,
+		K &&keyFunction,
+		I &&initialValue,
+		C &&combine,
+		const Backend &backend = Backend()
+	) :
+		m_enumerable(std::forward<Enumerable>(enumerable)),
+		m_aggregated(typename aggregated_t::allocator_type(backend.allocator)),
+		m_keyFunction(std::forward<K>(keyFunction)),
+		m_initialValue(std::forward<I>(initialValue)),
+		m_combine(std::forward<C>(combine)){}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the begin.
+	 *
+	 * This function causes the sequence to be eagerly aggregated and returns
+	 * the iterator.
+	 *
+	 * **Complexity**
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already aggregated
+	 * - O(N) otherwise (where N is size of internal sequence)
+	 */
+	iterator
+	begin() {
+		materialize(m_enumerable);
+		return std::begin(m_aggregated);
+	}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the end.
+	 */
+	iterator
+	end() {
+		return std::end(m_aggregated);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the begin.
+	 *
+	 * This function causes the sequence to be eagerly aggregated and returns
+	 * the iterator.
+	 *
+	 * **Complexity**
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already aggregated
+	 * - O(N) otherwise (where N is size of internal sequence)
+	 */
+	const_iterator
+	begin() const {
+		materialize(m_enumerable);
+		return std::begin(m_aggregated);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the end.
+	 */
+	const_iterator
+	end() const {
+		return std::end(m_aggregated);
+	}
+
+	/**
+	 * \brief Aggregates the sequence and pushes (key, accumulator) pairs to
+	 *     given callback until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		materialize(m_enumerable);
+		return detail::for_each(m_aggregated, callback);
+	}
+
+	/**
+	 * \brief Returns size hint.
+	 *
+	 * Each key comes from at least one element, so size of input sequence is
+	 * an upper bound of number of pairs.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::subset_size_hint(meta::get_size_hint(m_enumerable));
+	}
+
+	/**
+	 * \brief Discards accumulators, so that the sequence is aggregated again
+	 *     on next call to begin().
+	 *
+	 * Useful with materialize_once_t when the input sequence has changed.
+	 * Iterators obtained earlier may be invalidated by the next begin().
+	 */
+	void
+	refresh() const {
+		m_isMaterialized = false;
+	}
+
+private:
+	void
+	materialize(const Enumerable &enumerable) const {
+		if (std::is_same<Materialization, materialize_once_t>::value && m_isMaterialized)
+			return;
+
+		m_aggregated.clear();
+		detail::for_each(enumerable, [this](const auto &value) {
+			accumulate(m_keyFunction(value), value);
+		});
+		m_isMaterialized = true;
+	}
+
+	// Initial value is copied only for keys which were not seen before.
+	template<class Value>
+	void
+	accumulate(const key_type &key, const Value &value) const {
+		auto found = detail::find_or_emplace(m_aggregated, key, m_initialValue);
+		found->second = m_combine(std::move(found->second), value);
+	}
+
+	Enumerable m_enumerable;
+	mutable aggregated_t m_aggregated;
+	KeyFunction m_keyFunction;
+	InitialValue m_initialValue;
+	Combine m_combine;
+	mutable bool m_isMaterialized = false;
+};
+
+template<
+	class Materialization,
+	class Backend,
+	class Enumerable,
+	class KeyFunction,
+	class InitialValue,
+	class Combine
+>
+aggregated_sequence<Enumerable, KeyFunction, InitialValue, Combine, Materialization, Backend>
+make_aggregated(
+	Enumerable &&enumerable,
+	KeyFunction &&keyFunction,
+	InitialValue &&initialValue,
+	Combine &&combine,
+	const Backend &backend
+){
+	return aggregated_sequence<Enumerable, KeyFunction, InitialValue, Combine, Materialization, Backend>(
+		std::forward<Enumerable>(enumerable),
+		std::forward<KeyFunction>(keyFunction),
+		std::forward<InitialValue>(initialValue),
+		std::forward<Combine>(combine),
+		backend
+	);
+}
+
+template<
+	class KeyFunction,
+	class InitialValue,
+	class Combine,
+	class Materialization = rebuild_on_begin_t,
+	class Backend = flat_hash_grouping_policy
+>
+class aggregating_factory {
+public:
+	aggregating_factory(
+		KeyFunction &&keyFunction,
+		InitialValue &&initialValue,
+		Combine &&combine,
+		const Backend &backend = Backend()
+	) :
+		m_keyFunction(std::forward<KeyFunction>(keyFunction)),
+		m_initialValue(std::forward<InitialValue>(initialValue)),
+		m_combine(std::forward<Combine>(combine)),
+		m_backend(backend){}
+
+	template<class Enumerable>
+	aggregated_sequence<
+		Enumerable,
+		const KeyFunction &,
+		const InitialValue &,
+		const Combine &,
+		Materialization,
+		Backend
+	>
+	create(Enumerable &&enumerable) const & {
+		return make_aggregated<Materialization, Backend>(
+			std::forward<Enumerable>(enumerable),
+			m_keyFunction,
+			m_initialValue,
+			m_combine,
+			m_backend
+		);
+	}
+
+	template<class Enumerable>
+	aggregated_sequence<Enumerable, KeyFunction, InitialValue, Combine, Materialization, Backend>
+	create(Enumerable &&enumerable) && {
+		return make_aggregated<Materialization, Backend>(
+			std::forward<Enumerable>(enumerable),
+			std::forward<KeyFunction>(m_keyFunction),
+			std::forward<InitialValue>(m_initialValue),
+			std::forward<Combine>(m_combine),
+			m_backend
+		);
+	}
+private:
+	KeyFunction m_keyFunction;
+	InitialValue m_initialValue;
+	Combine m_combine;
+	Backend m_backend;
+};
+
+/**
+ * \brief Piping operator grouping input sequence by keys and folding every
+ *     group into single value.
+ *
+ * Result is equivalent to group_by followed by left fold of every group, but
+ * elements are folded as they are read, without being stored in groups.
+ *
+ * \tparam KeyFunction Type of function computing keys of elements. It must
+ *     take one argument constructible from Enumerable::value_type and return
+ *     any copy-constructible type.
+ * \tparam InitialValue Type of initial value of every accumulator. Must be
+ *     copy-constructible.
+ * \tparam Combine Type of function folding elements into accumulator. It must
+ *     take accumulator and element and return value convertible to
+ *     accumulator.
+ * \tparam Backend Type of grouping backend. By default accumulators are stored
+ *     in flat hash table and iterated in order of first occurrence of keys.
+ * \tparam Materialization Type of materialization mode. By default sequence
+ *     is aggregated on every call to begin().
+ *
+ * \param keyFunction Function computing keys of elements.
+ * \param initialValue Initial value of every accumulator.
+ * \param combine Function folding elements into accumulators.
+ * \param backend Grouping backend, tpl::flat_hash_grouping or
+ *     tpl::unordered_map_grouping, possibly called with an allocator.
+ * \param materialization Materialization mode, tpl::rebuild_on_begin or
+ *     tpl::materialize_once.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 2, 3, 4, 5 };
+ *     const auto sums = input | tpl::aggregate_by(
+ *         [](auto i){ return i < 3; },
+ *         0,
+ *         [](auto sum, auto i){ return sum + i; }
+ *     );
+ *     for (const auto &pair : sums)
+ *         std::cout << pair.first << ": " << pair.second << std::endl;
+ *     // output will be
+ *     // true: 3
+ *     // false: 12
+ */
+template<
+	class KeyFunction,
+	class InitialValue,
+	class Combine,
+	class Backend = flat_hash_grouping_policy,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<meta::is_grouping_backend<Backend>::value>::type
+>
+aggregating_factory<KeyFunction, InitialValue, Combine, Materialization, Backend>
+aggregate_by(
+	KeyFunction &&keyFunction,
+	InitialValue &&initialValue,
+	Combine &&combine,
+	const Backend &backend = Backend(),
+	const Materialization & = Materialization()
+){
+	return aggregating_factory<KeyFunction, InitialValue, Combine, Materialization, Backend>(
+		std::forward<KeyFunction>(keyFunction),
+		std::forward<InitialValue>(initialValue),
+		std::forward<Combine>(combine),
+		backend
+	);
+}
+
+/**
+ * \brief Piping operator aggregating input sequence using default grouping
+ *     backend and given materialization mode.
+ */
+template<
+	class KeyFunction,
+	class InitialValue,
+	class Combine,
+	class Materialization,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+aggregating_factory<KeyFunction, InitialValue, Combine, Materialization>
+aggregate_by(
+	KeyFunction &&keyFunction,
+	InitialValue &&initialValue,
+	Combine &&combine,
+	const Materialization &
+){
+	return aggregating_factory<KeyFunction, InitialValue, Combine, Materialization>(
+		std::forward<KeyFunction>(keyFunction),
+		std::forward<InitialValue>(initialValue),
+		std::forward<Combine>(combine)
+	);
+}
+
+}
@@ -6,11 +6,19 @@
 
 #include "../meta/is_enumerable.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
 
+#include "../detail/allocator.hpp"
+#include "../detail/for_each.hpp"
+#include "../detail/once_guard.hpp"
+
+#include "../common/synchronization.hpp"
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace tpl{
@@ -23,19 +31,32 @@ namespace tpl{
  * sequence and stores the results so that they are available immidiately.
  * This class due to its nature CANNOT be used with infinite sequences.
  *
+ * With thread_safe_t synchronization the sequence can be shared between
+ * threads: the cache is filled exactly once, by the first thread reaching it,
+ * and afterwards it is read without taking any lock. Copying the sequence
+ * must not race with the first fill.
+ *
  * This class complies with is_enumerable trait, which allows it to be used in
  * a pipeline.
  *
  * \tparam Enumerable Type of sequence to be cached. Must satisfy is_enumerable trait.
+ * \tparam Synchronization Either single_threaded_t (cache is filled without
+ *     synchronization) or thread_safe_t (cache is filled once even if the
+ *     sequence is iterated by many threads at once).
+ * \tparam Allocator Allocator used, after rebinding, to store cached elements.
  */
-template<class Enumerable>
+template<
+	class Enumerable,
+	class Synchronization = single_threaded_t,
+	class Allocator = detail::default_allocator
+>
 class cached_sequence : meta::enforce_enumerable<Enumerable> {
 public:
 	using enumerable_traits = meta::enumerable_traits<Enumerable>;
 
 	//! Type of values returned from dereferencing iterators.
 	using value_type = typename enumerable_traits::value_type;
-	using cached_t = std::vector<value_type>;
+	using cached_t = std::vector<value_type, detail::rebind_alloc_t<Allocator, value_type>>;
 
 	//! Type of const_iterator.
 	using const_iterator = typename cached_t::const_iterator;
@@ -51,11 +72,12 @@ public:
 	 * - O(N) for lvalue references (where N is size of enumerable)
 	 *
 	 * \param enumerable Sequence which is to be cached.
+	 * \param allocator Allocator of cached elements.
 	 */
-	cached_sequence(Enumerable &&enumerable) :
+	cached_sequence(Enumerable &&enumerable, const Allocator &allocator = Allocator()) :
 		m_enumerable(std::forward<Enumerable>(enumerable)),
-		m_wasFilled(false),
-		m_cached() {}
+		m_fillGuard(),
+		m_cached(typename cached_t::allocator_type(allocator)) {}
 
 	/**
 	 * \brief Creates and returns iterator pointing at the begin.
@@ -109,33 +131,134 @@ public:
 		return std::end(m_cached);
 	}
 
+	/**
+	 * \brief Pushes cached elements to given callback until it returns false.
+	 *
+	 * **Complexity**  
+	 * O(N) complexity when is called before any begin() or end(),
+	 * O(k) on any subsequent call (where k is number of pushed elements)
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		fillCache(m_enumerable);
+		return detail::for_each(m_cached, callback);
+	}
+
+	/**
+	 * \brief Returns number of cached elements.
+	 *
+	 * **Complexity**  
+	 * O(N) complexity when is called before any begin() or end(),
+	 * O(1) on any subsequent call
+	 */
+	std::size_t
+	size() const {
+		fillCache(m_enumerable);
+		return m_cached.size();
+	}
+
+	/**
+	 * \brief Returns size hint, which is exact once the sequence was cached
+	 *     and the same as of input sequence before.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return m_fillGuard.is_done() ?
+			meta::size_hint::exact(m_cached.size()) :
+			meta::get_size_hint(m_enumerable);
+	}
+
 private:
 	void
 	fillCache(const Enumerable &enumerable) const {
-		if(!m_wasFilled) {
+		m_fillGuard.call([this, &enumerable]{
+			const auto hint = meta::get_size_hint(enumerable);
+			m_cached.clear();
+			if (hint.is_exact())
+				m_cached.reserve(hint.value);
+
 			std::copy(
 				enumerable_traits::begin(enumerable),
 				enumerable_traits::end(enumerable),
 				std::back_inserter(m_cached)
 			);
-			m_wasFilled = true;
-		}
+		});
 	}
 
 	Enumerable m_enumerable;
-	mutable bool m_wasFilled = false;
+	// Declared before m_cached, so copies read the flag before the cache.
+	mutable detail::once_guard<Synchronization> m_fillGuard;
 	mutable cached_t m_cached;
 };
 
+template<
+	class Synchronization = single_threaded_t,
+	class Allocator = detail::default_allocator
+>
 class cache_factory {
 public:
+	cache_factory() = default;
+
+	explicit cache_factory(const Allocator &allocator) :
+		m_allocator(allocator) {}
+
 	template<class Enumerable>
-	cached_sequence<Enumerable>
+	cached_sequence<Enumerable, Synchronization, Allocator>
 	create(Enumerable &&enumerable) const {
-		return cached_sequence<Enumerable>(
-			std::forward<Enumerable>(enumerable)
+		return cached_sequence<Enumerable, Synchronization, Allocator>(
+			std::forward<Enumerable>(enumerable),
+			m_allocator
 		);
 	}
+
+	/**
+	 * \brief Returns operator caching input sequence with given
+	 *     synchronization mode.
+	 *
+	 * \param synchronization tpl::single_threaded or tpl::thread_safe.
+	 */
+	template<
+		class Mode,
+		class = typename std::enable_if<meta::is_synchronization<Mode>::value>::type
+	>
+	cache_factory<Mode, Allocator>
+	operator()(const Mode &) const {
+		return cache_factory<Mode, Allocator>(m_allocator);
+	}
+
+	/**
+	 * \brief Returns operator caching input sequence with elements stored
+	 *     using given allocator.
+	 */
+	template<
+		class OtherAllocator,
+		class = typename std::enable_if<!meta::is_synchronization<OtherAllocator>::value>::type,
+		class = void
+	>
+	cache_factory<Synchronization, OtherAllocator>
+	operator()(const OtherAllocator &allocator) const {
+		return cache_factory<Synchronization, OtherAllocator>(allocator);
+	}
+
+	/**
+	 * \brief Returns operator caching input sequence with given
+	 *     synchronization mode and elements stored using given allocator.
+	 */
+	template<class Mode, class OtherAllocator>
+	cache_factory<Mode, OtherAllocator>
+	operator()(const Mode &, const OtherAllocator &allocator) const {
+		static_assert(
+			meta::is_synchronization<Mode>::value,
+			"First argument must be tpl::single_threaded or tpl::thread_safe"
+		);
+		return cache_factory<Mode, OtherAllocator>(allocator);
+	}
+
+private:
+	Allocator m_allocator;
 };
 
 /**
@@ -146,10 +269,20 @@ public:
  * sequence and stores the results so that they are available immidiately.
  * This operator CANNOT be used with infinite sequences.
  *
+ * Called with tpl::thread_safe it returns operator creating sequences which
+ * can be iterated by many threads at once, filling the cache only once.
+ * Called with an allocator (optionally after the synchronization mode) it
+ * returns operator storing cached elements using that allocator.
+ *
  * **Complexity**  
  * - O(1) for rvalue references
  * - O(N) for lvalue references (N is size of enumerable)
+ *
+ * **Example**
+ *
+ *     const auto shared = input | tpl::transform(expensive) | tpl::cache(tpl::thread_safe);
+ *     // any number of threads can iterate over shared
  */
-const cache_factory cache;
+const cache_factory<> cache{};
 
 }
@@ -0,0 +1,317 @@
+/**
+ * \file
+ * \brief File defining operator which splits given sequence into runs of
+ *     consecutive elements with equal keys.
+ */
+#pragma once
+
+#include "../meta/is_enumerable.hpp"
+#include "../meta/enumerable_traits.hpp"
+#include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/pointer_proxy.hpp"
+#include "../detail/iterator_base.hpp"
+#include "../detail/counted_range.hpp"
+#include "../detail/for_each.hpp"
+
+#include "../common/composite_factory.hpp"
+#include "../common/apply_operator.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+
+template<class SubIterator, class Enumerable, class KeyFunction>
+class chunking_iterator :
+	public detail::input_iterator_base<
+		chunking_iterator<SubIterator, Enumerable, KeyFunction>
+	> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+	using sub_traits_t = std::iterator_traits<SubIterator>;
+	using key_type = typename std::decay<decltype(
+		std::declval<const KeyFunction &>()(*std::declval<SubIterator>())
+	)>::type;
+	using run_type = detail::counted_range<SubIterator>;
+	using value_type = std::pair<key_type, run_type>;
+	using difference_type = typename sub_traits_t::difference_type;
+	using reference = value_type;
+	using pointer = detail::pointer_proxy<value_type>;
+	using iterator_category = typename meta::demote_to_forward_tag<sub_traits_t>::type;
+
+	chunking_iterator() = default;
+	chunking_iterator(const chunking_iterator &) = default;
+	chunking_iterator(chunking_iterator &&) = default;
+
+	chunking_iterator &
+	operator=(const chunking_iterator &) = default;
+	chunking_iterator &
+	operator=(chunking_iterator &&) = default;
+
+	~chunking_iterator() noexcept = default;
+
+	//! Creates iterator pointing at run starting with given element.
+	chunking_iterator(
+		SubIterator runBegin,
+		const Enumerable *enumerable,
+		const KeyFunction &keyFunction
+	) :
+		m_runBegin(runBegin),
+		m_runEnd(std::move(runBegin)),
+		m_enumerable(enumerable),
+		m_keyFunction(&keyFunction) {
+		find_run_end();
+	}
+
+	//! Creates iterator pointing past the last run.
+	explicit chunking_iterator(SubIterator last) :
+		m_runBegin(last),
+		m_runEnd(std::move(last)) {}
+
+	chunking_iterator &
+	next() {
+		m_runBegin = m_runEnd;
+		find_run_end();
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		return value_type(m_key, run_type(m_runBegin, m_runLength));
+	}
+
+	pointer
+	operator->() const {
+		return detail::make_pointer_proxy(**this);
+	}
+
+	bool
+	operator==(const chunking_iterator &other) const {
+		return m_runBegin == other.m_runBegin;
+	}
+
+private:
+	// Keys are compared with the key of the first element of the run, which
+	// is kept for dereferencing. Key of the element ending the run is kept
+	// for the next run, so each element has its key computed once.
+	void
+	find_run_end() {
+		const auto last = enumerable_traits::end(*m_enumerable);
+		m_runLength = 0;
+		if (m_runEnd == last)
+			return;
+
+		m_key = m_hasNextKey ? std::move(m_nextKey) : (*m_keyFunction)(*m_runEnd);
+		m_hasNextKey = false;
+		for (++m_runEnd, ++m_runLength; m_runEnd != last; ++m_runEnd, ++m_runLength) {
+			m_nextKey = (*m_keyFunction)(*m_runEnd);
+			if (!(m_nextKey == m_key)) {
+				m_hasNextKey = true;
+				return;
+			}
+		}
+	}
+
+	SubIterator m_runBegin;
+	SubIterator m_runEnd;
+	std::size_t m_runLength = 0;
+	key_type m_key{};
+	key_type m_nextKey{};
+	bool m_hasNextKey = false;
+	const Enumerable *m_enumerable = nullptr;
+	const KeyFunction *m_keyFunction = nullptr;
+};
+
+/**
+ * \brief Sequence splitting input sequence into runs of consecutive elements
+ *     having equal keys.
+ *
+ * Each element of the sequence is a pair of key of a run and the run itself,
+ * which is a sequence viewing elements of input sequence in place. Nothing is
+ * copied or stored, so memory usage does not depend on length of input.
+ *
+ * Unlike grouped_sequence it does not merge runs with equal keys which are
+ * not adjacent, so it is meant for input already sorted or clustered by key.
+ *
+ * This class can be safely used with infinite sequences, as long as every run
+ * is finite - end of each run is found when the iterator reaches it.
+ *
+ * Runs stay valid as long as the input sequence is not modified. For input
+ * sequences with input iterators, e.g. generators, elements of a run are
+ * computed again when the run is traversed.
+ *
+ * This class complies with is_enumerable trait, which allows it to be used in
+ * a pipeline.
+ *
+ * \tparam Enumerable Type of sequence which is to be split. Must satisfy
+ *      is_enumerable trait.
+ * \tparam KeyFunction Type of function computing keys of elements. It must
+ *      take one argument constructible from Enumerable::value_type and return
+ *      default-constructible and copyable type comparable with operator==.
+ */
+template<class Enumerable, class KeyFunction>
+class chunked_sequence : meta::enforce_enumerable<Enumerable> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+
+	//! Type of const_iterator.
+	using const_iterator = chunking_iterator<
+		typename enumerable_traits::const_iterator,
+		typename enumerable_traits::enumerable_type,
+		typename std::remove_reference<KeyFunction>::type
+	>;
+
+	//! Type of iterator.
+	using iterator = const_iterator;
+
+	//! Type of values returned from dereferencing iterators.
+	using value_type = typename const_iterator::value_type;
+
+	/**
+	 * \brief Creates new chunked_sequence from given sequence and key function.
+	 *
+	 * **Complexity**
+	 * - O(1) for rvalue references of enumerable
+	 * - O(N) for lvalue references of enumerable (where N is size of enumerable)
+	 *
+	 * \param enumerable Sequence which is to be split.
+	 * \param op Function computing keys of elements.
+	 */
+	template<class T>
+	chunked_sequence(
+		Enumerable &&enumerable,
+		T &&op
+	) :
+		m_enumerable(std::forward<Enumerable>(enumerable)),
+		m_keyFunction(std::forward<T>(op)) {}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the first run.
+	 *
+	 * **Complexity**
+	 * O(k) where k is length of the first run
+	 */
+	const_iterator
+	begin() const {
+		return const_iterator(
+			enumerable_traits::begin(m_enumerable),
+			&m_enumerable,
+			m_keyFunction
+		);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing past the last run.
+	 */
+	const_iterator
+	end() const {
+		return const_iterator(enumerable_traits::end(m_enumerable));
+	}
+
+	/**
+	 * \brief Pushes runs to given callback until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		const auto last = end();
+		for (auto first = begin(); first != last; ++first)
+			if (!detail::invoke_callback(callback, *first))
+				return false;
+		return true;
+	}
+
+	/**
+	 * \brief Returns size hint.
+	 *
+	 * Each run holds at least one element, so size of input sequence is an
+	 * upper bound of number of runs.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::subset_size_hint(meta::get_size_hint(m_enumerable));
+	}
+
+private:
+	Enumerable m_enumerable;
+	KeyFunction m_keyFunction;
+};
+
+template<class Enumerable, class KeyFunction>
+chunked_sequence<Enumerable, KeyFunction>
+make_chunked(Enumerable &&enumerable, KeyFunction &&keyFunction){
+	return chunked_sequence<Enumerable, KeyFunction>(
+		std::forward<Enumerable>(enumerable),
+		std::forward<KeyFunction>(keyFunction)
+	);
+}
+
+template<class KeyFunction>
+class chunk_factory {
+public:
+	explicit chunk_factory(KeyFunction &&keyFunction) :
+		m_keyFunction(std::forward<KeyFunction>(keyFunction)){}
+
+	template<class Enumerable>
+	chunked_sequence<Enumerable, const KeyFunction &>
+	create(Enumerable &&enumerable) const & {
+		return make_chunked(
+			std::forward<Enumerable>(enumerable),
+			m_keyFunction
+		);
+	}
+
+	template<class Enumerable>
+	chunked_sequence<Enumerable, KeyFunction>
+	create(Enumerable &&enumerable) && {
+		return make_chunked(
+			std::forward<Enumerable>(enumerable),
+			std::forward<KeyFunction>(m_keyFunction)
+		);
+	}
+private:
+	KeyFunction m_keyFunction;
+};
+
+/**
+ * \brief Piping operator splitting input sequence into runs of consecutive
+ *     elements having equal keys.
+ *
+ * Runs are found lazily and view elements of input sequence in place, so the
+ * operator takes constant memory. It can be safely used with infinite
+ * sequences, as long as every run is finite.
+ *
+ * \tparam KeyFunction Type of function computing keys of elements. It must
+ *     take one argument constructible from value_type of input sequence and
+ *     return default-constructible and copyable type comparable with operator==.
+ *
+ * \param keyFunction Function computing keys of elements. This function
+ *     CANNOT have side-effects.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 1, 2, 3, 3, 1 };
+ *     const auto runs = input | tpl::chunk_by([](auto i){ return i; });
+ *     for (const auto &run : runs)
+ *         std::cout << run.first << ": " << run.second.size() << std::endl;
+ *     // output will be
+ *     // 1: 2
+ *     // 2: 1
+ *     // 3: 2
+ *     // 1: 1
+ */
+template<class KeyFunction>
+chunk_factory<KeyFunction>
+chunk_by(KeyFunction &&keyFunction){
+	return chunk_factory<KeyFunction>(
+		std::forward<KeyFunction>(keyFunction)
+	);
+}
+
+}
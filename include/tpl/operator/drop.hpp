@@ -7,14 +7,21 @@
 #include "../meta/is_enumerable.hpp"
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
+#include "../meta/rebuilds_on_begin.hpp"
 
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
+#include "../detail/iterator_cache.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
@@ -25,6 +32,14 @@ namespace tpl{
  *
  * This class can be safely used with infinite sequences.
  *
+ * If the wrapped sequence does not have random access iterators, position
+ * after dropped elements is computed on first call to begin() and reused
+ * afterwards. refresh() has to be called if the wrapped sequence changes.
+ * While the position is cached, begin() does not call begin() of the wrapped
+ * sequence, so e.g. a wrapped sorted sequence is not sorted again. Position
+ * is never cached if begin() of the wrapped sequence rebuilds its elements
+ * (see meta::rebuilds_on_begin), as each such call invalidates it.
+ *
  * This class complies with is_enumerable trait, which allows it to be used in
  * a pipeline.
  *
@@ -70,15 +85,14 @@ public:
 	 *
 	 * **Complexity**  
 	 * - O(1) if wrapped sequence has uses random access iterator
+	 * - O(1) if the iterator was already computed and cached
 	 * - O(k) otherwise (k is number of elements to drop) 
 	 */
 	iterator
 	begin() {
-		return std::distance(enumerable_traits::begin(m_enumerable),
-			enumerable_traits::end(m_enumerable)) > m_toDrop ?
-				std::next(enumerable_traits::begin(m_enumerable), m_toDrop) :
-				enumerable_traits::end(m_enumerable
-		);
+		return m_begin.get([this]{
+			return first<iterator>(m_enumerable, is_random_access<iterator>());
+		});
 	}
 
 	/**
@@ -97,15 +111,14 @@ public:
 	 *
 	 * **Complexity**  
 	 * - O(1) if wrapped sequence has uses random access iterator
+	 * - O(1) if the iterator was already computed and cached
 	 * - O(k) otherwise (k is number of elements to drop) 
 	 */
 	const_iterator
 	begin() const {
-		return std::distance(enumerable_traits::begin(m_enumerable), 
-			enumerable_traits::end(m_enumerable)) > m_toDrop ?
-				std::next(enumerable_traits::begin(m_enumerable), m_toDrop) :
-				enumerable_traits::end(m_enumerable
-		);
+		return m_begin.get_const([this]{
+			return first<const_iterator>(m_enumerable, is_random_access<const_iterator>());
+		});
 	}
 
 	/**
@@ -119,9 +132,97 @@ public:
 		return enumerable_traits::end(m_enumerable);
 	}
 
+	/**
+	 * \brief Pushes elements following the dropped ones to given callback
+	 *     until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		auto toDrop = m_toDrop;
+		return detail::for_each(m_enumerable, [&](const auto &value) {
+			if (toDrop > 0) {
+				--toDrop;
+				return true;
+			}
+			return detail::invoke_callback(callback, value);
+		});
+	}
+
+	/**
+	 * \brief Returns number of elements remaining after dropping.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		const std::size_t inputSize = meta::get_size(m_enumerable);
+		return inputSize > m_toDrop ? inputSize - m_toDrop : 0;
+	}
+
+	/**
+	 * \brief Returns size hint of input sequence reduced by number of dropped
+	 *     elements.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::drop_size_hint(meta::get_size_hint(m_enumerable), m_toDrop);
+	}
+
+	/**
+	 * \brief Discards cached begin position, so that it is computed again on
+	 *     next call to begin().
+	 *
+	 * Has to be called when the wrapped sequence changes.
+	 */
+	void
+	refresh() const {
+		m_begin.reset();
+	}
+
 private:
+	template<class Iterator>
+	using is_random_access = meta::is_random_access_iterator<
+		std::iterator_traits<Iterator>
+	>;
+
+	template<class Iterator, class E>
+	Iterator
+	first(E &enumerable, std::true_type) const {
+		const auto first = enumerable_traits::begin(enumerable);
+		const auto last = enumerable_traits::end(enumerable);
+		using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+		return last - first > static_cast<difference_type>(m_toDrop) ?
+			first + m_toDrop :
+			last;
+	}
+
+	template<class Iterator, class E>
+	Iterator
+	first(E &enumerable, std::false_type) const {
+		Iterator first = enumerable_traits::begin(enumerable);
+		const Iterator last = enumerable_traits::end(enumerable);
+		for (auto toDrop = m_toDrop; toDrop > 0 && first != last; --toDrop)
+			++first;
+		return first;
+	}
+
+	// Random access positions are computed in O(1), so they are not cached.
+	using begin_cache_t = detail::begin_cache<
+		iterator,
+		const_iterator,
+		!is_random_access<const_iterator>::value && !meta::rebuilds_on_begin<Enumerable>::value
+	>;
+
 	Enumerable m_enumerable;
 	unsigned m_toDrop;
+	mutable begin_cache_t m_begin;
 };
 
 class drop_factory {
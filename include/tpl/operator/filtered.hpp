@@ -8,8 +8,12 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
+#include "../meta/rebuilds_on_begin.hpp"
 
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
+#include "../detail/iterator_cache.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
@@ -99,6 +103,14 @@ private:
  *
  * This class can be safely used with infinite sequences.
  *
+ * Position of the first element satisfying the predicate is found on first
+ * call to begin() and reused afterwards. refresh() has to be called if the
+ * wrapped sequence changes. While the position is cached, begin() does not
+ * call begin() of the wrapped sequence, so e.g. a wrapped sorted sequence is
+ * not sorted again. Position is never cached if begin() of the wrapped
+ * sequence rebuilds its elements (see meta::rebuilds_on_begin), as each such
+ * call invalidates it.
+ *
  * This class complies with is_enumerable trait, which allows it to be used in
  * a pipeline.
  *
@@ -152,14 +164,20 @@ public:
 
 	/**
 	 * \brief Creates and returns iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * - O(1) if the iterator was already computed and cached
+	 * - O(k) otherwise (k is position of first element satisfying predicate)
 	 */
 	iterator
 	begin() {
-		return iterator(
-			enumerable_traits::begin(m_enumerable),
-		   	&m_enumerable,
-			m_filterPredicate
-		);
+		return m_begin.get([this]{
+			return iterator(
+				enumerable_traits::begin(m_enumerable),
+				&m_enumerable,
+				m_filterPredicate
+			);
+		});
 	}
 
 	/**
@@ -176,14 +194,20 @@ public:
 
 	/**
 	 * \brief Creates and returns const_iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * - O(1) if the iterator was already computed and cached
+	 * - O(k) otherwise (k is position of first element satisfying predicate)
 	 */
 	const_iterator
 	begin() const {
-		return const_iterator(
-			enumerable_traits::begin(m_enumerable),
-		   	&m_enumerable,
-			m_filterPredicate
-		);
+		return m_begin.get_const([this]{
+			return const_iterator(
+				enumerable_traits::begin(m_enumerable),
+				&m_enumerable,
+				m_filterPredicate
+			);
+		});
 	}
 
 	/**
@@ -198,9 +222,48 @@ public:
 		);
 	}
 
+	/**
+	 * \brief Pushes elements satisfying the predicate to given callback until
+	 *     it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		return detail::for_each(m_enumerable, [this, &callback](const auto &value) {
+			return !m_filterPredicate(value) || detail::invoke_callback(callback, value);
+		});
+	}
+
+	/**
+	 * \brief Returns size hint, which is an upper bound equal to size of input
+	 *     sequence if the latter is known.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::subset_size_hint(meta::get_size_hint(m_enumerable));
+	}
+
+	/**
+	 * \brief Discards cached begin position, so that it is found again on
+	 *     next call to begin().
+	 *
+	 * Has to be called when the wrapped sequence changes.
+	 */
+	void
+	refresh() const {
+		m_begin.reset();
+	}
+
 private:
 	Enumerable m_enumerable;
 	FilterPredicate m_filterPredicate;
+	mutable detail::begin_cache<
+		iterator,
+		const_iterator,
+		!meta::rebuilds_on_begin<Enumerable>::value
+	> m_begin;
 };
 
 template<class Enumerable, class FilterPredicate>
@@ -8,8 +8,10 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
 
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
@@ -235,6 +237,33 @@ public:
 	end() const {
 		return const_iterator(enumerable_traits::end(m_enumerable), &m_enumerable);
 	}
+
+	/**
+	 * \brief Pushes elements of all internal sequences to given callback until
+	 *     it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		return detail::for_each(m_enumerable, [&callback](const auto &internal) {
+			return detail::for_each(internal, callback);
+		});
+	}
+
+	/**
+	 * \brief Returns size hint.
+	 *
+	 * Number of elements is not known without visiting all internal sequences,
+	 * so the hint is exact only for empty input sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		const auto hint = meta::get_size_hint(m_enumerable);
+		return hint.is_exact() && hint.value == 0 ? hint : meta::size_hint::unknown();
+	}
+
 private:
 	Enumerable m_enumerable;
 };
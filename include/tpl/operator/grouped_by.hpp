@@ -7,16 +7,170 @@
 #include "../meta/is_enumerable.hpp"
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
 
+#include "../detail/allocator.hpp"
+#include "../detail/for_each.hpp"
+#include "../detail/flat_hash_map.hpp"
+#include "../detail/grouping.hpp"
+
+#include "../executor/executor.hpp"
+
+#include "../common/materialization.hpp"
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
+#include "parallel.hpp"
+
+#include <functional>
 #include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
 namespace tpl{
 
+/**
+ * \brief Grouping backend storing groups in open addressing hash table with
+ *     groups kept in one dense array.
+ *
+ * Groups are iterated in order of first occurrence of their keys in the input
+ * sequence. Adding a key costs no separate allocation. This is the default
+ * backend of group_by.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the table and for
+ *     every group. Calling the backend object with another allocator returns
+ *     backend using that one, e.g. `tpl::flat_hash_grouping(arenaAllocator)`.
+ */
+template<class Allocator>
+struct basic_flat_hash_grouping_policy {
+	template<class Key, class Mapped>
+	using table = detail::flat_hash_map<
+		Key,
+		Mapped,
+		std::hash<Key>,
+		std::equal_to<Key>,
+		detail::rebind_alloc_t<Allocator, std::pair<const Key, Mapped>>
+	>;
+
+	template<class Value>
+	using group = std::vector<Value, detail::rebind_alloc_t<Allocator, Value>>;
+
+	//! Allocator of the table and of groups.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_flat_hash_grouping_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_flat_hash_grouping_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+/**
+ * \brief Grouping backend storing groups in std::unordered_map.
+ *
+ * Order of groups is unspecified. Every key costs separate allocation, but
+ * references to groups are stable, as in any std::unordered_map.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the table and for
+ *     every group. Calling the backend object with another allocator returns
+ *     backend using that one.
+ */
+template<class Allocator>
+struct basic_unordered_map_grouping_policy {
+	template<class Key, class Mapped>
+	using table = std::unordered_map<
+		Key,
+		Mapped,
+		std::hash<Key>,
+		std::equal_to<Key>,
+		detail::rebind_alloc_t<Allocator, std::pair<const Key, Mapped>>
+	>;
+
+	template<class Value>
+	using group = std::vector<Value, detail::rebind_alloc_t<Allocator, Value>>;
+
+	//! Allocator of the table and of groups.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_unordered_map_grouping_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_unordered_map_grouping_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+//! Grouping backend storing groups in flat hash table with std::allocator.
+using flat_hash_grouping_policy = basic_flat_hash_grouping_policy<detail::default_allocator>;
+
+//! Grouping backend storing groups in std::unordered_map with std::allocator.
+using unordered_map_grouping_policy = basic_unordered_map_grouping_policy<detail::default_allocator>;
+
+/**
+ * \brief Grouping backend grouping random access input sequence on executor.
+ *
+ * Every thread groups its chunk of the input into its own tables, which are
+ * then merged per hash partition, so threads never share a table. Groups are
+ * stored as with flat_hash_grouping_policy, and the result is exactly the same
+ * as the one of sequential grouping, whatever the number of threads. Other
+ * input sequences are grouped sequentially.
+ *
+ * Objects of this type are created by passing tpl::par to group_by.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the table, for every
+ *     group and for tables of partial groups built by threads. Calling the
+ *     backend object with another allocator returns backend using that one.
+ */
+template<class Allocator>
+struct basic_parallel_grouping_policy {
+	template<class Key, class Mapped>
+	using table = typename basic_flat_hash_grouping_policy<Allocator>::template table<Key, Mapped>;
+
+	template<class Value>
+	using group = typename basic_flat_hash_grouping_policy<Allocator>::template group<Value>;
+
+	//! Executor grouping chunks of the input.
+	executor *chunkExecutor;
+
+	//! Maximal number of chunks grouped concurrently.
+	unsigned concurrency;
+
+	//! Allocator of the table and of groups.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_parallel_grouping_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_parallel_grouping_policy<OtherAllocator>{ chunkExecutor, concurrency, otherAllocator };
+	}
+};
+
+//! Grouping backend grouping on executor with std::allocator.
+using parallel_grouping_policy = basic_parallel_grouping_policy<detail::default_allocator>;
+
+//! Object of flat_hash_grouping_policy which can be passed to group_by.
+const flat_hash_grouping_policy flat_hash_grouping{};
+
+//! Object of unordered_map_grouping_policy which can be passed to group_by.
+const unordered_map_grouping_policy unordered_map_grouping{};
+
+namespace meta{
+
+template<class T>
+struct is_grouping_backend_impl : std::false_type {};
+
+template<class Allocator>
+struct is_grouping_backend_impl<basic_flat_hash_grouping_policy<Allocator>> : std::true_type {};
+
+template<class Allocator>
+struct is_grouping_backend_impl<basic_unordered_map_grouping_policy<Allocator>> : std::true_type {};
+
+template<class T>
+struct is_grouping_backend : is_grouping_backend_impl<typename std::decay<T>::type> {};
+
+}
+
 /**
  * \brief Sequence grouping input sequence into associative container of
  *     sequences using given predicate.
@@ -32,8 +186,18 @@ namespace tpl{
  * \tparam Grouping Type of function used to group elements from enumerable. 
  *      It must take one argument constructible from Enumerable::value_type
  *      and return any copy-constructible type.
+ * \tparam Materialization Either rebuild_on_begin_t (sequence is grouped on
+ *      every begin() call) or materialize_once_t (sequence is grouped on first
+ *      begin() call and then only after refresh()).
+ * \tparam Backend Type of grouping backend, basic_flat_hash_grouping_policy,
+ *      basic_unordered_map_grouping_policy or basic_parallel_grouping_policy.
  */
-template<class Enumerable, class Grouping>
+template<
+	class Enumerable,
+	class Grouping,
+	class Materialization = rebuild_on_begin_t,
+	class Backend = flat_hash_grouping_policy
+>
 class grouped_sequence :
 	meta::enforce_enumerable<Enumerable> {
 public:
@@ -53,8 +217,8 @@ public:
 	 * 
 	 * This type is a sequence of values of type Enumerable::value_type.
 	 */
-	using mapped_type = std::vector<typename enumerable_traits::value_type>;
-	using grouped_t = std::unordered_map<key_type, mapped_type>;
+	using mapped_type = typename Backend::template group<typename enumerable_traits::value_type>;
+	using grouped_t = typename Backend::template table<key_type, mapped_type>;
 
 	//! Type of values returned from dereferencing iterators.
 	using value_type = typename grouped_t::value_type;
@@ -74,15 +238,18 @@ public:
 	 *
 	 * \param enumerable Sequence which is to be grouped.
 	 * \param op Function used to group elements in given input sequence.
+	 * \param backend Grouping backend.
 	 */
 	template<class T>
 	grouped_sequence(
 		Enumerable &&enumerable,
-	   	T &&op
+	   	T &&op,
+		const Backend &backend = Backend()
 	) :
 		m_enumerable(std::forward<Enumerable>(enumerable)),
-		m_grouped(),
-		m_groupingFunction(op){}
+		m_grouped(typename grouped_t::allocator_type(backend.allocator)),
+		m_groupingFunction(op),
+		m_backend(backend){}
 
 	/**
 	 * \brief Creates and returns iterator pointing at the begin.
@@ -91,11 +258,13 @@ public:
 	 * iterator.
 	 *
 	 * **Complexity** 
-	 * O(N) (where N is size of internal sequence)
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already grouped
+	 * - O(N) otherwise (where N is size of internal sequence)
 	 */
 	iterator
 	begin() {
-		group(m_enumerable);
+		materialize(m_enumerable);
 		return std::begin(m_grouped);
 	}
 
@@ -114,11 +283,13 @@ public:
 	 * iterator.
 	 *
 	 * **Complexity** 
-	 * O(N) (where N is size of internal sequence)
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already grouped
+	 * - O(N) otherwise (where N is size of internal sequence)
 	 */
 	const_iterator
 	begin() const {
-		group(m_enumerable);
+		materialize(m_enumerable);
 		return std::begin(m_grouped);
 	}
 
@@ -130,53 +301,122 @@ public:
 		return std::end(m_grouped);
 	}
 
+	/**
+	 * \brief Groups the sequence and pushes groups to given callback until
+	 *     it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		materialize(m_enumerable);
+		return detail::for_each(m_grouped, callback);
+	}
+
+	/**
+	 * \brief Returns size hint.
+	 *
+	 * Each group holds at least one element, so size of input sequence is an
+	 * upper bound of number of groups.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::subset_size_hint(meta::get_size_hint(m_enumerable));
+	}
+
+	/**
+	 * \brief Discards grouped elements, so that the sequence is grouped again
+	 *     on next call to begin().
+	 *
+	 * Useful with materialize_once_t when the input sequence has changed.
+	 * Iterators obtained earlier may be invalidated by the next begin().
+	 */
+	void
+	refresh() const {
+		m_isMaterialized = false;
+	}
+
 private:
 	void
-	group(const Enumerable &enumerable) const {
+	materialize(const Enumerable &enumerable) const {
+		if (std::is_same<Materialization, materialize_once_t>::value && m_isMaterialized)
+			return;
+
 		m_grouped.clear();
-		for (const auto &value : enumerable)
-			m_grouped[m_groupingFunction(value)].push_back(value);
+		group(enumerable, m_backend);
+		m_isMaterialized = true;
+	}
+
+	template<class Policy>
+	void
+	group(const Enumerable &enumerable, const Policy &) const {
+		detail::group(std::begin(enumerable), std::end(enumerable), m_grouped, m_groupingFunction);
+	}
+
+	template<class Allocator>
+	void
+	group(const Enumerable &enumerable, const basic_parallel_grouping_policy<Allocator> &policy) const {
+		detail::parallel_group(
+			std::begin(enumerable),
+			std::end(enumerable),
+			m_grouped,
+			m_groupingFunction,
+			*policy.chunkExecutor,
+			policy.concurrency
+		);
 	}
 
 	Enumerable m_enumerable;
 	mutable grouped_t m_grouped;
 	Grouping m_groupingFunction;
+	Backend m_backend;
+	mutable bool m_isMaterialized = false;
 };
 
-template<class Enumerable, class Grouping>
-grouped_sequence<Enumerable, Grouping>
-make_grouped(Enumerable &&enumerable, Grouping &&predicate){
-	return grouped_sequence<Enumerable, Grouping>(
+template<class Materialization, class Backend, class Enumerable, class Grouping>
+grouped_sequence<Enumerable, Grouping, Materialization, Backend>
+make_grouped(Enumerable &&enumerable, Grouping &&predicate, const Backend &backend){
+	return grouped_sequence<Enumerable, Grouping, Materialization, Backend>(
 		std::forward<Enumerable>(enumerable),
-		std::forward<Grouping>(predicate)
+		std::forward<Grouping>(predicate),
+		backend
 	);
 }
 
-template<class Grouping>
+template<
+	class Grouping,
+	class Materialization = rebuild_on_begin_t,
+	class Backend = flat_hash_grouping_policy
+>
 class grouping_factory {
 public:
-	explicit grouping_factory(Grouping &&grouping) :
-		m_grouping(std::forward<Grouping>(grouping)){}
+	explicit grouping_factory(Grouping &&grouping, const Backend &backend = Backend()) :
+		m_grouping(std::forward<Grouping>(grouping)),
+		m_backend(backend){}
 
 	template<class Enumerable>
-	grouped_sequence<Enumerable, const Grouping &>
+	grouped_sequence<Enumerable, const Grouping &, Materialization, Backend>
 	create(Enumerable &&enumerable) const & {
-		return make_grouped(
+		return make_grouped<Materialization, Backend>(
 			std::forward<Enumerable>(enumerable),
-			m_grouping
+			m_grouping,
+			m_backend
 		);
 	}
 
 	template<class Enumerable>
-	grouped_sequence<Enumerable, Grouping>
+	grouped_sequence<Enumerable, Grouping, Materialization, Backend>
 	create(Enumerable &&enumerable) && {
-		return make_grouped(
+		return make_grouped<Materialization, Backend>(
 			std::forward<Enumerable>(enumerable),
-			std::forward<Grouping>(m_grouping)
+			std::forward<Grouping>(m_grouping),
+			m_backend
 		);
 	}
 private:
 	Grouping m_grouping;
+	Backend m_backend;
 };
 
 /**
@@ -189,8 +429,16 @@ private:
  * \tparam Grouping Type of function used to group elements from enumerable. 
  *     It must take one argument constructible from Enumerable::value_type
  *     and return any copy-constructible type.
+ * \tparam Backend Type of grouping backend. By default groups are stored in
+ *     flat hash table and iterated in order of first occurrence of keys.
+ * \tparam Materialization Type of materialization mode. By default sequence
+ *     is grouped on every call to begin().
  *
  * \param grouping Function used to group elements in given input sequence.
+ * \param backend Grouping backend, tpl::flat_hash_grouping or
+ *     tpl::unordered_map_grouping, possibly called with an allocator.
+ * \param materialization Materialization mode, tpl::rebuild_on_begin or
+ *     tpl::materialize_once.
  *
  * **Example**
  *
@@ -204,13 +452,117 @@ private:
  *	       // output will be 
  *         // true : { 1, 2, },
  *         // false : { 3, 4, 5, },
- *         // or the lines will be in reverse order
  *	   }
  */
-template<class Grouping>
-grouping_factory<Grouping>
-group_by(Grouping &&grouping){
-	return grouping_factory<Grouping>(std::forward<Grouping>(grouping));
+template<
+	class Grouping,
+	class Backend = flat_hash_grouping_policy,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<meta::is_grouping_backend<Backend>::value>::type
+>
+grouping_factory<Grouping, Materialization, Backend>
+group_by(
+	Grouping &&grouping,
+	const Backend &backend = Backend(),
+	const Materialization & = Materialization()
+){
+	return grouping_factory<Grouping, Materialization, Backend>(
+		std::forward<Grouping>(grouping),
+		backend
+	);
+}
+
+/**
+ * \brief Piping operator grouping input sequence using default grouping
+ *     backend and given materialization mode.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 2, 3, 4, 5 };
+ *     const auto grouped = input
+ *         | tpl::group_by([](auto i){ return i < 3; }, tpl::materialize_once);
+ */
+template<
+	class Grouping,
+	class Materialization,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+grouping_factory<Grouping, Materialization>
+group_by(Grouping &&grouping, const Materialization &){
+	return grouping_factory<Grouping, Materialization>(
+		std::forward<Grouping>(grouping)
+	);
+}
+
+/**
+ * \brief Piping operator grouping input sequence on many threads.
+ *
+ * Random access input sequence is grouped with parallel_grouping_policy on
+ * executor and with number of chunks of given tpl::par operator. Other input
+ * sequences are grouped sequentially.
+ *
+ * Result is deterministic: groups are iterated in order of first occurrence
+ * of their keys and elements of every group are in order of input, exactly as
+ * without tpl::par. Grouping function is called concurrently, once for every
+ * element, so it must be safe to call from many threads.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 2, 3, 4, 5 };
+ *     const auto grouped = input
+ *         | tpl::group_by([](auto i){ return i % 2; }, tpl::par);
+ */
+template<
+	class Grouping,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+grouping_factory<Grouping, Materialization, parallel_grouping_policy>
+group_by(
+	Grouping &&grouping,
+	const parallel_factory &parallel,
+	const Materialization & = Materialization()
+){
+	return grouping_factory<Grouping, Materialization, parallel_grouping_policy>(
+		std::forward<Grouping>(grouping),
+		parallel_grouping_policy{
+			&parallel.chunk_executor(),
+			parallel.concurrency(),
+			detail::default_allocator()
+		}
+	);
+}
+
+/**
+ * \brief Piping operator grouping input sequence on many threads, allocating
+ *     the table and groups with given allocator.
+ *
+ * **Example**
+ *
+ *     const auto grouped = input
+ *         | tpl::group_by([](auto i){ return i % 2; }, tpl::par, arenaAllocator);
+ */
+template<
+	class Grouping,
+	class Allocator,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<!meta::is_materialization<Allocator>::value>::type
+>
+grouping_factory<Grouping, Materialization, basic_parallel_grouping_policy<Allocator>>
+group_by(
+	Grouping &&grouping,
+	const parallel_factory &parallel,
+	const Allocator &allocator,
+	const Materialization & = Materialization()
+){
+	return grouping_factory<Grouping, Materialization, basic_parallel_grouping_policy<Allocator>>(
+		std::forward<Grouping>(grouping),
+		basic_parallel_grouping_policy<Allocator>{
+			&parallel.chunk_executor(),
+			parallel.concurrency(),
+			allocator
+		}
+	);
 }
 
 }
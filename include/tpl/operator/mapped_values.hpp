@@ -9,30 +9,50 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
 
+#include "../detail/pointer_proxy.hpp"
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
 template<class SubIterator>
 class mapped_values_iterator :
-	public detail::bidirectional_iterator_base<mapped_values_iterator<SubIterator>> {
+	public detail::bidirectional_or_random_access_iterator_base<
+		mapped_values_iterator<SubIterator>,
+		typename std::iterator_traits<SubIterator>::iterator_category,
+		typename std::iterator_traits<SubIterator>::difference_type
+	> {
 public:
 	using sub_traits_t = std::iterator_traits<SubIterator>;
 	using associative_traits_t = meta::associative_element_traits<typename sub_traits_t::value_type>;
-	using value_type = typename associative_traits_t::mapped_type;
+	using value_type = typename std::remove_cv<typename associative_traits_t::mapped_type>::type;
 	using difference_type = typename sub_traits_t::difference_type;
-	using reference = value_type;
-	using pointer = const value_type *;
-	using iterator_category = typename meta::demote_to_bidirectional_tag<
-		sub_traits_t
+
+	// Elements of input sequence held in place are referenced. Only if the
+	// wrapped iterator returns pairs by value, e.g. when they are computed,
+	// are the mapped values returned by value.
+	using is_referencing_t = std::is_lvalue_reference<typename sub_traits_t::reference>;
+	using reference = typename std::conditional<
+		is_referencing_t::value,
+		const value_type &,
+		value_type
+	>::type;
+	using pointer = typename std::conditional<
+		is_referencing_t::value,
+		const value_type *,
+		detail::pointer_proxy<value_type>
 	>::type;
+	using iterator_category = typename sub_traits_t::iterator_category;
 
 	mapped_values_iterator() = default;
 	mapped_values_iterator(const mapped_values_iterator &) = default;
@@ -62,6 +82,17 @@ public:
 		return *this;
 	}
 
+	mapped_values_iterator &
+	advance(difference_type offset) {
+		m_subIterator += offset;
+		return *this;
+	}
+
+	difference_type
+	distance_to(const mapped_values_iterator &other) const {
+		return other.m_subIterator - m_subIterator;
+	}
+
 	reference
 	operator*() const {
 		return associative_traits_t::mapped_value(*(this->m_subIterator));
@@ -69,7 +100,7 @@ public:
 
 	pointer
 	operator->() const {
-		return &associative_traits_t::mapped_value(*(this->m_subIterator));
+		return make_pointer(**this, is_referencing_t());
 	}
 
 	bool
@@ -78,6 +109,16 @@ public:
 	}
 
 private:
+	static pointer
+	make_pointer(const value_type &value, std::true_type) {
+		return &value;
+	}
+
+	static pointer
+	make_pointer(value_type value, std::false_type) {
+		return detail::make_pointer_proxy(std::move(value));
+	}
+
 	SubIterator m_subIterator;
 };
 
@@ -139,7 +180,7 @@ public:
 	 */
 	iterator
 	end() {
-		return iterator(enumerable_traits::begin(m_enumerable));
+		return iterator(enumerable_traits::end(m_enumerable));
 	}
 
 	/**
@@ -157,6 +198,42 @@ public:
 	end() const {
 		return const_iterator(enumerable_traits::end(m_enumerable));
 	}
+
+	/**
+	 * \brief Pushes mapped values to given callback until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		using associative_traits_t = typename const_iterator::associative_traits_t;
+		return detail::for_each(m_enumerable, [&callback](const auto &value) {
+			return detail::invoke_callback(callback, associative_traits_t::mapped_value(value));
+		});
+	}
+	/**
+	 * \brief Returns number of elements, which is the same as number of elements in input sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns size hint, which is the same as of input sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
 private:
 	Enumerable m_enumerable;
 };
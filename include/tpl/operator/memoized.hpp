@@ -0,0 +1,256 @@
+/**
+ * \file
+ * \brief File defining operator which memoizes elements of given sequence as
+ *     they are read.
+ */
+#pragma once
+
+#include "../meta/is_enumerable.hpp"
+#include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/allocator.hpp"
+#include "../detail/iterator_base.hpp"
+#include "../detail/memo_buffer.hpp"
+#include "../detail/for_each.hpp"
+
+#include "../common/composite_factory.hpp"
+#include "../common/apply_operator.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace tpl{
+
+template<class Buffer, class Enumerable, class ValueType>
+class memoizing_iterator :
+	public detail::input_iterator_base<
+		memoizing_iterator<Buffer, Enumerable, ValueType>
+	> {
+public:
+	using value_type = ValueType;
+	using difference_type = std::ptrdiff_t;
+	using reference = const value_type &;
+	using pointer = const value_type *;
+	using iterator_category = std::forward_iterator_tag;
+
+	memoizing_iterator() = default;
+
+	memoizing_iterator(Buffer *buffer, const Enumerable *enumerable, std::size_t index) :
+		m_buffer(buffer),
+		m_enumerable(enumerable),
+		m_index(index) {}
+
+	memoizing_iterator &
+	next() {
+		++m_index;
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		m_buffer->reach(m_index, *m_enumerable);
+		return (*m_buffer)[m_index];
+	}
+
+	pointer
+	operator->() const {
+		return &**this;
+	}
+
+	// Comparing with the end iterator reads the element at the position of
+	// this iterator, as it is the only way to tell if the sequence ended.
+	bool
+	operator==(const memoizing_iterator &other) const {
+		return m_index == other.m_index || (is_end() && other.is_end());
+	}
+
+	//! Position of the iterator past the last element, whatever their number.
+	static std::size_t
+	end_index() {
+		return static_cast<std::size_t>(-1);
+	}
+
+private:
+	bool
+	is_end() const {
+		return m_index == end_index() || !m_buffer->reach(m_index, *m_enumerable);
+	}
+
+	Buffer *m_buffer = nullptr;
+	const Enumerable *m_enumerable = nullptr;
+	std::size_t m_index = 0;
+};
+
+/**
+ * \brief Sequence storing elements of input sequence as they are read, so
+ *     that each of them is computed only once.
+ *
+ * Unlike cached_sequence, it reads input sequence only as far as any of its
+ * iterators has advanced, so it can be safely used with infinite sequences
+ * and the first call to begin() costs nothing. All iterators share elements
+ * read so far, which are stored in a buffer keeping their addresses stable
+ * as it grows.
+ *
+ * Copies of the sequence do not share read elements - a copy reads input
+ * sequence again. The sequence must not be iterated by many threads at once.
+ *
+ * This class complies with is_enumerable trait, which allows it to be used in
+ * a pipeline.
+ *
+ * \tparam Enumerable Type of sequence to be memoized. Must satisfy
+ *     is_enumerable trait.
+ * \tparam Allocator Allocator used, after rebinding, to store read elements.
+ */
+template<class Enumerable, class Allocator = detail::default_allocator>
+class memoized_sequence : meta::enforce_enumerable<Enumerable> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+
+	//! Type of values returned from dereferencing iterators.
+	using value_type = typename enumerable_traits::value_type;
+	using buffer_t = detail::memo_buffer<
+		typename enumerable_traits::const_iterator,
+		value_type,
+		Allocator
+	>;
+
+	//! Type of const_iterator.
+	using const_iterator = memoizing_iterator<
+		buffer_t,
+		typename enumerable_traits::enumerable_type,
+		value_type
+	>;
+
+	//! Type of iterator.
+	using iterator = const_iterator;
+
+	/**
+	 * \brief Creates new memoized_sequence from given sequence.
+	 *
+	 * **Complexity**
+	 * - O(1) for rvalue references
+	 * - O(N) for lvalue references (where N is size of enumerable)
+	 *
+	 * \param enumerable Sequence which is to be memoized.
+	 * \param allocator Allocator of read elements.
+	 */
+	memoized_sequence(Enumerable &&enumerable, const Allocator &allocator = Allocator()) :
+		m_enumerable(std::forward<Enumerable>(enumerable)),
+		m_buffer(allocator) {}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * O(1), no element is read
+	 */
+	const_iterator
+	begin() const {
+		return const_iterator(&m_buffer, &m_enumerable, 0);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the end.
+	 *
+	 * **Complexity**
+	 * O(1), no element is read
+	 */
+	const_iterator
+	end() const {
+		return const_iterator(&m_buffer, &m_enumerable, const_iterator::end_index());
+	}
+
+	/**
+	 * \brief Pushes elements to given callback until it returns false, reading
+	 *     input sequence only for elements which were not read before.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		for (std::size_t index = 0; m_buffer.reach(index, m_enumerable); ++index)
+			if (!detail::invoke_callback(callback, m_buffer[index]))
+				return false;
+		return true;
+	}
+
+	/**
+	 * \brief Returns size hint, which is the same as of input sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns number of elements read from input sequence so far.
+	 */
+	std::size_t
+	memoized_count() const {
+		return m_buffer.size();
+	}
+
+private:
+	Enumerable m_enumerable;
+	mutable buffer_t m_buffer;
+};
+
+template<class Allocator = detail::default_allocator>
+class memoize_factory {
+public:
+	memoize_factory() = default;
+
+	explicit memoize_factory(const Allocator &allocator) :
+		m_allocator(allocator) {}
+
+	template<class Enumerable>
+	memoized_sequence<Enumerable, Allocator>
+	create(Enumerable &&enumerable) const {
+		return memoized_sequence<Enumerable, Allocator>(
+			std::forward<Enumerable>(enumerable),
+			m_allocator
+		);
+	}
+
+	/**
+	 * \brief Returns operator storing read elements using given allocator.
+	 */
+	template<class OtherAllocator>
+	memoize_factory<OtherAllocator>
+	operator()(const OtherAllocator &allocator) const {
+		return memoize_factory<OtherAllocator>(allocator);
+	}
+
+private:
+	Allocator m_allocator;
+};
+
+/**
+ * \brief Piping operator memoizing elements of input sequence as they are
+ *     read.
+ *
+ * Input sequence is read lazily, only as far as iterators of the result
+ * advance, and each element is read once however many times and by however
+ * many iterators it is visited. This operator can be safely used with
+ * infinite sequences. Called with an allocator it returns operator storing
+ * read elements using that allocator.
+ *
+ * **Complexity**
+ * - O(1) for rvalue references
+ * - O(N) for lvalue references (N is size of enumerable)
+ *
+ * **Example**
+ *
+ *     const auto results = tpl::generator([](auto i){ return i + 1; }, 0)
+ *         | tpl::transform(expensive)
+ *         | tpl::memoize;
+ *     // expensive is called once for each element, however many times
+ *     // results is iterated
+ */
+const memoize_factory<> memoize{};
+
+}
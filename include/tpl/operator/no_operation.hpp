@@ -7,12 +7,17 @@
 #include "../meta/is_enumerable.hpp"
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
@@ -95,6 +100,40 @@ public:
 		return enumerable_traits::end(m_enumerable);
 	}
 
+	/**
+	 * \brief Pushes elements of the wrapped sequence to given callback until
+	 *     it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		return detail::for_each(m_enumerable, callback);
+	}
+
+	/**
+	 * \brief Returns number of elements of the wrapped sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns size hint of the wrapped sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
 private:
 	Enumerable m_enumerable;
 };
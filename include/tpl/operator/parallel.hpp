@@ -0,0 +1,302 @@
+/**
+ * \file
+ * \brief File defining operator which allows sinks to process elements of
+ *     input sequence on many threads.
+ */
+#pragma once
+
+#include "../meta/is_enumerable.hpp"
+#include "../meta/enumerable_traits.hpp"
+#include "../meta/iterators.hpp"
+#include "../meta/is_parallel.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
+
+#include "../executor/executor.hpp"
+
+#include "../common/composite_factory.hpp"
+#include "../common/apply_operator.hpp"
+
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+
+namespace tpl{
+
+/**
+ * \brief Sequence wrapping given sequence and marking it as one which can be
+ *     consumed in parallel.
+ *
+ * Iterating over this sequence is the same as iterating over the wrapped one.
+ * However sinks (count, any, all and fold_left) consuming it split the wrapped
+ * sequence into chunks, run all preceding stages of the pipeline on each chunk
+ * as separate task of an executor and combine partial results. Chunks are created only if
+ * iterators of the wrapped sequence are random access, otherwise elements are
+ * processed on calling thread.
+ *
+ * Functions passed to the preceding stages and to the sink are called
+ * concurrently, so they must be safe to call from many threads.
+ *
+ * This class complies with is_enumerable trait, which allows it to be used in
+ * a pipeline.
+ *
+ * \tparam Enumerable Type of sequence which is to be wrapped.
+ */
+template<class Enumerable>
+class parallel_sequence :
+	meta::enforce_enumerable<Enumerable> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+
+	/**
+	 * \brief Type of values returned from dereferencing iterators.
+	 *
+	 * This type is as the same as Enumerable::value_type.
+	 */
+	using value_type = typename enumerable_traits::value_type;
+
+	//! Type of const_iterator.
+	using const_iterator = typename enumerable_traits::const_iterator;
+
+	//! Type of iterator.
+	using iterator = typename enumerable_traits::iterator;
+
+	/**
+	 * \brief Creates new parallel_sequence from given sequence.
+	 *
+	 * **Complexity** 
+	 * - O(1) for rvalue references of enumerable
+	 * - O(N) for lvalue references of enumerable (where N is size of enumerable)
+	 *
+	 * \param enumerable Sequence which is to be wrapped.
+	 * \param chunkExecutor Executor running chunks of the sequence.
+	 * \param concurrency Maximal number of chunks.
+	 */
+	parallel_sequence(
+		Enumerable &&enumerable,
+		executor &chunkExecutor,
+		unsigned concurrency
+	) :
+		m_enumerable(std::forward<Enumerable>(enumerable)),
+		m_executor(&chunkExecutor),
+		m_concurrency(concurrency) {}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the begin.
+	 */
+	iterator
+	begin() {
+		return enumerable_traits::begin(m_enumerable);
+	}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the end.
+	 */
+	iterator
+	end() {
+		return enumerable_traits::end(m_enumerable);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the begin.
+	 */
+	const_iterator
+	begin() const {
+		return enumerable_traits::begin(m_enumerable);
+	}
+
+	/**
+	 * \brief Creates and returns const_iterator pointing at the end.
+	 */
+	const_iterator
+	end() const {
+		return enumerable_traits::end(m_enumerable);
+	}
+
+	/**
+	 * \brief Pushes elements of the wrapped sequence to given callback until
+	 *     it returns false.
+	 *
+	 * Elements are pushed sequentially on calling thread.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		return detail::for_each(m_enumerable, callback);
+	}
+
+	/**
+	 * \brief Reduces the wrapped sequence chunk by chunk.
+	 *
+	 * `reduceChunk(chunk, isLeading)` is called concurrently for each chunk,
+	 * where `isLeading` is true only for the chunk starting the sequence.
+	 * Partial results are combined with `combineResults` in order of chunks.
+	 *
+	 * **Complexity**
+	 * O(N / C) on each of C threads, where N is number of elements and C is
+	 * number of chunks.
+	 */
+	template<class Reduce, class Combine>
+	auto
+	reduce(Reduce &reduceChunk, Combine &combineResults) const
+		-> decltype(reduceChunk(std::declval<const Enumerable &>(), true)) {
+		return reduce(
+			reduceChunk,
+			combineResults,
+			meta::is_random_access_iterator<std::iterator_traits<const_iterator>>()
+		);
+	}
+
+	/**
+	 * \brief Returns number of elements of the wrapped sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns size hint of the wrapped sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns maximal number of chunks.
+	 */
+	unsigned
+	concurrency() const {
+		return m_concurrency;
+	}
+
+	/**
+	 * \brief Returns executor running chunks of the sequence.
+	 */
+	executor &
+	chunk_executor() const {
+		return *m_executor;
+	}
+
+private:
+	template<class Reduce, class Combine>
+	auto
+	reduce(Reduce &reduceChunk, Combine &combineResults, std::true_type) const
+		-> decltype(reduceChunk(std::declval<const Enumerable &>(), true)) {
+		return detail::reduce_chunks(
+			std::begin(m_enumerable),
+			std::end(m_enumerable),
+			*m_executor,
+			m_concurrency,
+			reduceChunk,
+			combineResults
+		);
+	}
+
+	template<class Reduce, class Combine>
+	auto
+	reduce(Reduce &reduceChunk, Combine &, std::false_type) const
+		-> decltype(reduceChunk(std::declval<const Enumerable &>(), true)) {
+		return reduceChunk(m_enumerable, true);
+	}
+
+	Enumerable m_enumerable;
+	executor *m_executor;
+	unsigned m_concurrency;
+};
+
+class parallel_factory {
+public:
+	parallel_factory(executor *chunkExecutor, unsigned concurrency) :
+		m_executor(chunkExecutor),
+		m_concurrency(concurrency) {}
+
+	template<class Enumerable>
+	parallel_sequence<Enumerable>
+	create(Enumerable &&enumerable) const {
+		return parallel_sequence<Enumerable>(
+			std::forward<Enumerable>(enumerable),
+			chunk_executor(),
+			concurrency()
+		);
+	}
+
+	/**
+	 * \brief Returns executor chunks are run on.
+	 */
+	executor &
+	chunk_executor() const {
+		return m_executor ? *m_executor : default_executor();
+	}
+
+	/**
+	 * \brief Returns maximal number of chunks.
+	 */
+	unsigned
+	concurrency() const {
+		return m_concurrency == 0 ? chunk_executor().worker_count() + 1 : m_concurrency;
+	}
+
+	/**
+	 * \brief Returns operator splitting the input into at most `concurrency`
+	 *     chunks.
+	 */
+	parallel_factory
+	operator()(unsigned concurrency) const {
+		return parallel_factory(m_executor, concurrency);
+	}
+
+	/**
+	 * \brief Returns operator running chunks of the input on given executor.
+	 *
+	 * Input is split into one chunk more than number of workers of the
+	 * executor, as the calling thread processes chunks as well.
+	 */
+	parallel_factory
+	operator()(executor &chunkExecutor) const {
+		return parallel_factory(&chunkExecutor, m_concurrency);
+	}
+
+private:
+	executor *m_executor;
+	unsigned m_concurrency;
+};
+
+/**
+ * \brief Piping operator allowing sinks to consume input sequence on many
+ *     threads.
+ *
+ * Chunks are run on tpl::default_executor(), or on executor given in
+ * `tpl::par(executor)`. Input sequence is split into as many chunks as there
+ * are threads of the executor, or as given in `tpl::par(concurrency)`, as long
+ * as each chunk has at least a thousand or so elements. Only sequences with random access iterators are
+ * split, e.g. vectors passed through transform, zip, take or drop.
+ *
+ * Sinks combine partial results of chunks, so functions passed to fold_left
+ * must be associative, i.e. `op(op(a, b), c) == op(a, op(b, c))`, and be able
+ * to take two partial results. Functions passed to all stages of the pipeline
+ * are called concurrently.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 2, 3, 4, 5 };
+ *     const int out = input
+ *         | tpl::transform([](int i){ return i * i; })
+ *         | tpl::par
+ *         | tpl::fold_left(std::plus<>(), 0);
+ *     // out == 55
+ */
+const parallel_factory par(nullptr, 0);
+
+}
@@ -9,14 +9,18 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
 
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
@@ -97,6 +101,44 @@ public:
 		return meta::make_reverse_iterator(enumerable_traits::begin(m_enumerable));
 	}
 
+	/**
+	 * \brief Pushes elements in reversed order to given callback until it
+	 *     returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		const auto last = end();
+		for (auto first = begin(); first != last; ++first)
+			if (!detail::invoke_callback(callback, *first))
+				return false;
+		return true;
+	}
+
+	/**
+	 * \brief Returns number of elements of the reversed sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns size hint of the reversed sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
 private:
 	Enumerable m_enumerable;
 };
@@ -7,15 +7,284 @@
 #include "../meta/is_enumerable.hpp"
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/size_hint.hpp"
 
+#include "../detail/allocator.hpp"
+#include "../detail/sort_engine.hpp"
+#include "../detail/external_sort_engine.hpp"
+#include "../detail/for_each.hpp"
+
+#include "parallel.hpp"
+
+#include "../executor/executor.hpp"
+
+#include "../common/materialization.hpp"
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
+#include <cstddef>
+#include <functional>
+#include <istream>
 #include <iterator>
-#include <set>
+#include <ostream>
+#include <string>
+#include <type_traits>
 
 namespace tpl{
 
+/**
+ * \brief Sorting policy gathering elements into one contiguous buffer and
+ *     sorting them in place.
+ *
+ * Sequences sorted with this policy expose random access iterators. Order of
+ * equivalent elements is preserved. Iterators address elements by position,
+ * so the one returned by end() stays valid when the sequence is sorted again.
+ * This is the default policy of sort.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the buffer. Calling
+ *     the policy object with another allocator returns policy using that one,
+ *     e.g. `tpl::contiguous_sort(arenaAllocator)`.
+ */
+template<class Allocator>
+struct basic_contiguous_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::contiguous_sort_engine<ValueType, Comparison, Allocator>;
+
+	//! Allocator of the buffer.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_contiguous_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_contiguous_sort_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+/**
+ * \brief Sorting policy inserting elements one by one into std::multiset.
+ *
+ * Sequences sorted with this policy expose bidirectional iterators. Order of
+ * equivalent elements is preserved. Every element costs separate allocation,
+ * so this policy should be used only when multiset semantics are needed.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for nodes of the
+ *     multiset. Calling the policy object with another allocator returns
+ *     policy using that one.
+ */
+template<class Allocator>
+struct basic_multiset_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::multiset_sort_engine<ValueType, Comparison, Allocator>;
+
+	//! Allocator of nodes of the multiset.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_multiset_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_multiset_sort_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+//! Sorting policy gathering elements into buffer allocated with std::allocator.
+using contiguous_sort_policy = basic_contiguous_sort_policy<detail::default_allocator>;
+
+//! Sorting policy inserting elements into multiset allocated with std::allocator.
+using multiset_sort_policy = basic_multiset_sort_policy<detail::default_allocator>;
+
+/**
+ * \brief Sorting policy gathering elements into one contiguous buffer and
+ *     sorting it on an executor.
+ *
+ * Buffer is split into chunks sorted concurrently, which are then merged
+ * pairwise, with merges of each round running concurrently. Sequences sorted
+ * with this policy expose random access iterators and order of equivalent
+ * elements is preserved, so the result is the same as with
+ * contiguous_sort_policy. This policy is selected by passing tpl::par to sort.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the buffer. Calling
+ *     the policy object with another allocator returns policy using that one.
+ */
+template<class Allocator>
+struct basic_parallel_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::parallel_sort_engine<ValueType, Comparison, Allocator>;
+
+	//! Executor running chunks of the sort.
+	executor *chunkExecutor;
+
+	//! Maximal number of chunks sorted concurrently.
+	unsigned concurrency;
+
+	//! Allocator of the buffer.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_parallel_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_parallel_sort_policy<OtherAllocator>{ chunkExecutor, concurrency, otherAllocator };
+	}
+};
+
+/**
+ * \brief Sorting policy ordering contiguous buffer by keys of elements, used
+ *     by sort_by.
+ *
+ * Key of each element is computed once, then (key, position) pairs are
+ * sorted with stable comparison sort and elements are moved to their sorted
+ * positions. Sequences sorted with this policy expose random access iterators
+ * and order of elements with equal keys is preserved.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the buffer and for
+ *     the (key, position) pairs.
+ */
+template<class Allocator>
+struct basic_decorated_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::projected_sort_engine<ValueType, Comparison, false, Allocator>;
+
+	//! Allocator of the buffer and of the keys.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_decorated_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_decorated_sort_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+/**
+ * \brief Sorting policy ordering contiguous buffer by keys of elements, used
+ *     by sort_by_key.
+ *
+ * Elements with integral or floating point keys compared with `<` or `>` are
+ * sorted with radix sort, other ones like with decorated_sort_policy.
+ * Sequences sorted with this policy expose random access iterators and order
+ * of elements with equal keys is preserved.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the buffer, the keys
+ *     and the buffers of radix sort.
+ */
+template<class Allocator>
+struct basic_key_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::projected_sort_engine<ValueType, Comparison, true, Allocator>;
+
+	//! Allocator of the buffer and of the keys.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_key_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_key_sort_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+/**
+ * \brief Sorting policy which orders elements lazily, as they are reached by
+ *     iterators, used by lazy_sort.
+ *
+ * Elements are gathered into a binary heap in O(N) time and each subsequent
+ * element is extracted from it in O(log(N)) time, when an iterator pointing
+ * at it is dereferenced. Sequences sorted with this policy expose forward
+ * iterators. Order of equivalent elements is preserved.
+ *
+ * \tparam Allocator Allocator used, after rebinding, for the heap.
+ */
+template<class Allocator>
+struct basic_lazy_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::lazy_sort_engine<ValueType, Comparison, Allocator>;
+
+	//! Allocator of the heap.
+	Allocator allocator;
+
+	template<class OtherAllocator>
+	basic_lazy_sort_policy<OtherAllocator>
+	operator()(const OtherAllocator &otherAllocator) const {
+		return basic_lazy_sort_policy<OtherAllocator>{ otherAllocator };
+	}
+};
+
+//! Sorting policy sorting on an executor buffer allocated with std::allocator.
+using parallel_sort_policy = basic_parallel_sort_policy<detail::default_allocator>;
+
+//! Sorting policy of sort_by allocating with std::allocator.
+using decorated_sort_policy = basic_decorated_sort_policy<detail::default_allocator>;
+
+//! Sorting policy of sort_by_key allocating with std::allocator.
+using key_sort_policy = basic_key_sort_policy<detail::default_allocator>;
+
+//! Sorting policy of lazy_sort allocating with std::allocator.
+using lazy_sort_policy = basic_lazy_sort_policy<detail::default_allocator>;
+
+/**
+ * \brief Serializer writing elements to run files of external_sort as raw
+ *     bytes. It can be used only with trivially copy constructible and
+ *     destructible types, e.g. std::pair of integers.
+ *
+ * Custom serializers must provide the same two const member functions,
+ * `write` returning nothing and `read` returning false when no more elements
+ * could be read.
+ */
+struct trivial_serializer {
+	template<class T>
+	void
+	write(std::ostream &stream, const T &value) const {
+		static_assert(
+			std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value,
+			"trivial_serializer requires trivially copyable type, pass custom serializer to external_sort"
+		);
+		stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template<class T>
+	bool
+	read(std::istream &stream, T &value) const {
+		static_assert(
+			std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value,
+			"trivial_serializer requires trivially copyable type, pass custom serializer to external_sort"
+		);
+		return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+	}
+};
+
+/**
+ * \brief Sorting policy spilling sorted runs of input to temporary files and
+ *     merging them while iterating, used by external_sort.
+ *
+ * Sequences sorted with this policy expose single pass input iterators and
+ * every call to begin() starts reading the runs again. Order of equivalent
+ * elements is preserved. Temporary files are removed when the sequence is
+ * destroyed or sorted again.
+ *
+ * \tparam Serializer Type of object writing elements to and reading them
+ *     from files, see trivial_serializer.
+ */
+template<class Serializer = trivial_serializer>
+struct external_sort_policy {
+	template<class ValueType, class Comparison>
+	using engine = detail::external_sort_engine<ValueType, Comparison, Serializer>;
+
+	//! Number of bytes of elements which are sorted in memory at once.
+	std::size_t memoryBudget;
+
+	//! Directory of temporary files.
+	std::string directory;
+
+	//! Serializer of elements.
+	Serializer serializer;
+};
+
+//! Object of contiguous_sort_policy which can be passed to sort.
+const contiguous_sort_policy contiguous_sort{};
+
+//! Object of multiset_sort_policy which can be passed to sort.
+const multiset_sort_policy multiset_sort{};
+
+template<class Enumerable, class Comparison, class Materialization, class Allocator>
+class partially_sorted_sequence;
+
 /**
  * \brief Sequence sorting elements in input sequence.
  *
@@ -30,8 +299,18 @@ namespace tpl{
  *     sequence. It must accept two arguments, each constructible from
  *     Enumerable::value_type and return bool. It must follow strict weak
  *     ordering.
+ * \tparam Policy Type of sorting policy, e.g. contiguous_sort_policy or
+ *     multiset_sort_policy.
+ * \tparam Materialization Either rebuild_on_begin_t (sequence is sorted on
+ *     every begin() call) or materialize_once_t (sequence is sorted on first
+ *     begin() call and then only after refresh()).
  */
-template<class Enumerable, class Comparison>
+template<
+	class Enumerable,
+	class Comparison,
+	class Policy = contiguous_sort_policy,
+	class Materialization = rebuild_on_begin_t
+>
 class sorted_sequence :
 	meta::enforce_enumerable<Enumerable> {
 public:
@@ -43,13 +322,13 @@ public:
 	 * This type is as the same as Enumerable::value_type.
 	 */
 	using value_type = typename enumerable_traits::value_type;
-	using sorted_t = std::multiset<value_type, Comparison>;
+	using engine_t = typename Policy::template engine<value_type, Comparison>;
 
 	//! Type of const_iterator.
-	using const_iterator = typename sorted_t::const_iterator;
+	using const_iterator = typename engine_t::const_iterator;
 
 	//! Type of iterator.
-	using iterator = typename sorted_t::iterator;
+	using iterator = typename engine_t::iterator;
 
 	/**
 	 * \brief Creates new sorted_sequence from given sequence and comparison
@@ -62,17 +341,19 @@ public:
 	 * \tparam T Type of function-like object passed to constructor. Must be
 	 *     convertible to Comparison type.
 	 *
-	 * \param enumerable Sequence which is to be reversed.
+	 * \param enumerable Sequence which is to be sorted.
 	 * \param op Function-like object used to compare elements of enumerable
 	 *     during sorting.
+	 * \param policy Sorting policy.
 	 */
 	template<class T>
 	sorted_sequence(
 		Enumerable &&enumerable,
-	   	T &&op
+	   	T &&op,
+		const Policy &policy = Policy()
 	) :
 		m_enumerable(std::forward<Enumerable>(enumerable)),
-		m_sorted(std::forward<T>(op)) {}
+		m_engine(std::forward<T>(op), policy) {}
 
 	sorted_sequence &operator=(sorted_sequence &) = delete;
 
@@ -81,12 +362,14 @@ public:
 	 *     the begin.
 	 *
 	 * **Complexity**
-	 * O(n log(n))
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already sorted
+	 * - O(n log(n)) otherwise
 	 */
 	iterator
 	begin() {
-		sort(m_enumerable);
-		return std::begin(m_sorted);
+		materialize(m_enumerable);
+		return m_engine.begin();
 	}
 
 	/**
@@ -94,7 +377,7 @@ public:
 	 */
 	iterator
 	end() {
-		return std::end(m_sorted);
+		return m_engine.end();
 	}
 
 	/**
@@ -102,12 +385,14 @@ public:
 	 *     pointing at the begin.
 	 *
 	 * **Complexity**
-	 * O(n log(n))
+	 * - O(1) if Materialization is materialize_once_t and the sequence was
+	 *   already sorted
+	 * - O(n log(n)) otherwise
 	 */
 	const_iterator
 	begin() const {
-		sort(m_enumerable);
-		return std::begin(m_sorted);
+		materialize(m_enumerable);
+		return m_engine.begin();
 	}
 
 	/**
@@ -115,58 +400,340 @@ public:
 	 */
 	const_iterator
 	end() const {
-		return std::end(m_sorted);
+		return m_engine.end();
+	}
+
+	/**
+	 * \brief Sorts the sequence and pushes sorted elements to given callback
+	 *     until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		materialize(m_enumerable);
+		return detail::for_each(m_engine, callback);
+	}
+
+	/**
+	 * \brief Discards sorted elements, so that the sequence is sorted again
+	 *     on next call to begin().
+	 *
+	 * Useful with materialize_once_t when the input sequence has changed.
+	 * Iterators obtained earlier may be invalidated by the next begin().
+	 */
+	void
+	refresh() const {
+		m_isMaterialized = false;
+	}
+
+	/**
+	 * \brief Returns number of elements, which is the same as in input
+	 *     sequence.
+	 *
+	 * Available only if input sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	//! Returns size hint, which is the same as of input sequence.
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
 	}
 
 private:
+	template<class E, class C, class P, class M>
+	friend partially_sorted_sequence<
+		E,
+		C,
+		M,
+		typename detail::engine_allocator<typename sorted_sequence<E, C, P, M>::engine_t>::type
+	>
+	make_taken(sorted_sequence<E, C, P, M> &&sorted, unsigned toTake);
+
 	void
-	sort(const Enumerable &enumerable) const {
-		m_sorted.clear();
-		std::copy(
+	materialize(const Enumerable &enumerable) const {
+		if (std::is_same<Materialization, materialize_once_t>::value && m_isMaterialized)
+			return;
+
+		m_engine.sort(
 			enumerable_traits::begin(enumerable),
 			enumerable_traits::end(enumerable),
-			std::inserter(m_sorted, m_sorted.begin())
+			meta::get_size_hint(enumerable)
 		);
+		m_isMaterialized = true;
 	}
 
 	Enumerable m_enumerable;
-	mutable sorted_t m_sorted;
+	mutable engine_t m_engine;
+	mutable bool m_isMaterialized = false;
 };
 
-template<class Enumerable, class Comparison>
-sorted_sequence<Enumerable, Comparison>
-make_sorted(Enumerable &&enumerable, Comparison &&predicate){
-	return sorted_sequence<Enumerable, Comparison>(
+/**
+ * \brief Sequence consisting of given number of first elements of input
+ *     sequence in sorted order.
+ *
+ * This sequence is created when sorted_sequence is piped into take. Instead
+ * of sorting whole input it keeps only the elements which will be taken, so
+ * sorting takes O(N log(k)) time and O(k) memory, where k is number of taken
+ * elements. Order of equivalent elements is the same as in sorted_sequence.
+ *
+ * This class **cannot** be safely used with infinite sequences.
+ *
+ * This class complies with is_enumerable trait, which allows it to be used in
+ * a pipeline.
+ *
+ * \tparam Enumerable Type of sequence which is to be sorted. Must satisfy
+ *      is_enumerable trait.
+ * \tparam Comparison Type of function supplied to compare elements in input
+ *     sequence. It must accept two arguments, each constructible from
+ *     Enumerable::value_type and return bool. It must follow strict weak
+ *     ordering.
+ * \tparam Materialization Materialization mode, the same as of sorted_sequence
+ *     from which this sequence was created.
+ * \tparam Allocator Allocator of kept elements, the same as of sorting policy
+ *     of sorted_sequence from which this sequence was created.
+ */
+template<
+	class Enumerable,
+	class Comparison,
+	class Materialization = rebuild_on_begin_t,
+	class Allocator = detail::default_allocator
+>
+class partially_sorted_sequence :
+	meta::enforce_enumerable<Enumerable> {
+public:
+	using enumerable_traits = meta::enumerable_traits<Enumerable>;
+
+	/**
+	 * \brief Type of values returned from dereferencing iterators.
+	 *
+	 * This type is as the same as Enumerable::value_type.
+	 */
+	using value_type = typename enumerable_traits::value_type;
+	using engine_t = detail::bounded_sort_engine<value_type, Comparison, Allocator>;
+
+	//! Type of const_iterator.
+	using const_iterator = typename engine_t::const_iterator;
+
+	//! Type of iterator.
+	using iterator = typename engine_t::iterator;
+
+	/**
+	 * \brief Creates new partially_sorted_sequence from given sequence,
+	 *     comparison function and number of elements to take.
+	 *
+	 * **Complexity** 
+	 * - O(1) for rvalue references of enumerable
+	 * - O(N) for lvalue references of enumerable (where N is size of enumerable)
+	 *
+	 * \tparam T Type of function-like object passed to constructor. Must be
+	 *     convertible to Comparison type.
+	 *
+	 * \param enumerable Sequence which is to be sorted.
+	 * \param op Function-like object used to compare elements of enumerable
+	 *     during sorting.
+	 * \param toTake Number of first elements of sorted order to keep.
+	 * \param allocator Allocator of kept elements.
+	 */
+	template<class T>
+	partially_sorted_sequence(
+		Enumerable &&enumerable,
+	   	T &&op,
+		unsigned toTake,
+		const Allocator &allocator = Allocator()
+	) :
+		m_enumerable(std::forward<Enumerable>(enumerable)),
+		m_engine(std::forward<T>(op), toTake, allocator) {}
+
+	partially_sorted_sequence &operator=(partially_sorted_sequence &) = delete;
+
+	/**
+	 * \brief Selects and sorts first elements of the sequence. Then creates
+	 *     and returns iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * - O(1) if Materialization is materialize_once_t and the elements were
+	 *   already selected
+	 * - O(n log(k)) otherwise
+	 */
+	iterator
+	begin() {
+		materialize(m_enumerable);
+		return m_engine.begin();
+	}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the end.
+	 */
+	iterator
+	end() {
+		return m_engine.end();
+	}
+
+	/**
+	 * \brief Selects and sorts first elements of the sequence. Then creates
+	 *     and returns const_iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * - O(1) if Materialization is materialize_once_t and the elements were
+	 *   already selected
+	 * - O(n log(k)) otherwise
+	 */
+	const_iterator
+	begin() const {
+		materialize(m_enumerable);
+		return m_engine.begin();
+	}
+
+	/**
+	 * \brief Creates and returns iterator pointing at the end.
+	 */
+	const_iterator
+	end() const {
+		return m_engine.end();
+	}
+
+	/**
+	 * \brief Sorts the sequence and pushes sorted elements to given callback
+	 *     until it returns false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		materialize(m_enumerable);
+		return detail::for_each(m_engine, callback);
+	}
+
+	/**
+	 * \brief Discards sorted elements, so that the sequence is sorted again
+	 *     on next call to begin().
+	 *
+	 * Useful with materialize_once_t when the input sequence has changed.
+	 * Iterators obtained earlier may be invalidated by the next begin().
+	 */
+	void
+	refresh() const {
+		m_isMaterialized = false;
+	}
+
+	//! Returns size hint of input sequence clamped to number of taken elements.
+	meta::size_hint
+	size_hint() const {
+		return meta::take_size_hint(
+			meta::get_size_hint(m_enumerable),
+			m_engine.to_take()
+		);
+	}
+
+private:
+	void
+	materialize(const Enumerable &enumerable) const {
+		if (std::is_same<Materialization, materialize_once_t>::value && m_isMaterialized)
+			return;
+
+		m_engine.sort(
+			enumerable_traits::begin(enumerable),
+			enumerable_traits::end(enumerable),
+			meta::get_size_hint(enumerable)
+		);
+		m_isMaterialized = true;
+	}
+
+	Enumerable m_enumerable;
+	mutable engine_t m_engine;
+	mutable bool m_isMaterialized = false;
+};
+
+/**
+ * \brief Overload of make_taken used when sorted_sequence is piped into take.
+ *
+ * Sorting is then fused with taking, so only taken elements are ordered.
+ * It is used both for `input | sort(cmp) | take(k)` and for composite
+ * `sort(cmp) | take(k)`. With sort_by and sort_by_key keys are stored next to
+ * elements kept in the heap, so the projection is still called once per
+ * element. Kept elements are allocated with allocator of the sorting policy.
+ */
+template<class Enumerable, class Comparison, class Policy, class Materialization>
+partially_sorted_sequence<
+	Enumerable,
+	Comparison,
+	Materialization,
+	typename detail::engine_allocator<
+		typename sorted_sequence<Enumerable, Comparison, Policy, Materialization>::engine_t
+	>::type
+>
+make_taken(
+	sorted_sequence<Enumerable, Comparison, Policy, Materialization> &&sorted,
+	unsigned toTake
+){
+	using engine_allocator_t = detail::engine_allocator<
+		typename sorted_sequence<Enumerable, Comparison, Policy, Materialization>::engine_t
+	>;
+	return partially_sorted_sequence<Enumerable, Comparison, Materialization, typename engine_allocator_t::type>(
+		std::forward<Enumerable>(sorted.m_enumerable),
+		sorted.m_engine.comparison(),
+		toTake,
+		engine_allocator_t::get(sorted.m_engine)
+	);
+}
+
+template<class Materialization, class Enumerable, class Comparison, class Policy>
+sorted_sequence<Enumerable, Comparison, Policy, Materialization>
+make_sorted(Enumerable &&enumerable, Comparison &&predicate, const Policy &policy){
+	return sorted_sequence<Enumerable, Comparison, Policy, Materialization>(
 		std::forward<Enumerable>(enumerable),
-		std::forward<Comparison>(predicate)
+		std::forward<Comparison>(predicate),
+		policy
 	);
 }
 
-template<class Comparison>
+template<
+	class Comparison,
+	class Policy = contiguous_sort_policy,
+	class Materialization = rebuild_on_begin_t
+>
 class compare_factory {
 public:
-	explicit compare_factory(Comparison &&compareComparison) :
-		m_comparison(std::forward<Comparison>(compareComparison)){}
+	explicit compare_factory(
+		Comparison &&compareComparison,
+		const Policy &policy = Policy()
+	) :
+		m_comparison(std::forward<Comparison>(compareComparison)),
+		m_policy(policy){}
 
 	template<class Enumerable>
-	sorted_sequence<Enumerable, const Comparison &>
+	sorted_sequence<Enumerable, const Comparison &, Policy, Materialization>
 	create(Enumerable &&enumerable) const & {
-		return make_sorted(
+		return make_sorted<Materialization>(
 			std::forward<Enumerable>(enumerable),
-			m_comparison
+			m_comparison,
+			m_policy
 		);
 	}
 
 	template<class Enumerable>
-	sorted_sequence<Enumerable, Comparison>
+	sorted_sequence<Enumerable, Comparison, Policy, Materialization>
 	create(Enumerable &&enumerable) && {
-		return make_sorted(
+		return make_sorted<Materialization>(
 			std::forward<Enumerable>(enumerable),
-			std::forward<Comparison>(m_comparison)
+			std::forward<Comparison>(m_comparison),
+			m_policy
 		);
 	}
 private:
 	Comparison m_comparison;
+	Policy m_policy;
 };
 
 /**
@@ -182,8 +749,18 @@ private:
  *     value_type of input sequence and return bool. It must follow strict weak
  *     ordering.
  *
+ * \tparam Policy Type of sorting policy. By default elements are sorted in
+ *     contiguous buffer and exposed through random access iterators.
+ *
+ * \tparam Materialization Type of materialization mode. By default sequence
+ *     is sorted on every call to begin().
+ *
  * \param comparison Function-like object used to compare elements of enumerable
  *     during sorting.
+ * \param policy Sorting policy, e.g. tpl::contiguous_sort or tpl::multiset_sort.
+ *     Passing tpl::par sorts on many threads.
+ * \param materialization Materialization mode, tpl::rebuild_on_begin or
+ *     tpl::materialize_once.
  *
  * **Example**
  *
@@ -191,11 +768,380 @@ private:
  *     const auto out = input | tpl::sort([](auto i, auto j){ return i < j; });
  *     for (auto value : out) 
  *         std::cout << value << ", ";//output will be 1, 2, 3, 4, 5,
+ *
+ * When result of this operator is piped into tpl::take only the taken
+ * elements are sorted, see partially_sorted_sequence.
+ */
+template<
+	class Comparison,
+	class Policy = contiguous_sort_policy,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<!meta::is_materialization<Policy>::value>::type
+>
+compare_factory<Comparison, Policy, Materialization>
+sort(
+	Comparison &&comparison,
+	const Policy &policy = Policy(),
+	const Materialization & = Materialization()
+){
+	return compare_factory<Comparison, Policy, Materialization>(
+		std::forward<Comparison>(comparison),
+		policy
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence on many threads.
+ *
+ * Elements are sorted with parallel_sort_policy on executor and with number
+ * of chunks of given tpl::par operator. Result is the same as of sequential
+ * sort, as long as comparison follows strict weak ordering. Comparison is
+ * called concurrently.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 3, 5, 2, 4 };
+ *     const auto out = input | tpl::sort(std::less<>(), tpl::par);
+ *     for (auto value : out)
+ *         std::cout << value << ", ";//output will be 1, 2, 3, 4, 5,
+ */
+template<
+	class Comparison,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+compare_factory<Comparison, parallel_sort_policy, Materialization>
+sort(
+	Comparison &&comparison,
+	const parallel_factory &parallel,
+	const Materialization & = Materialization()
+){
+	return compare_factory<Comparison, parallel_sort_policy, Materialization>(
+		std::forward<Comparison>(comparison),
+		parallel_sort_policy{ &parallel.chunk_executor(), parallel.concurrency(), detail::default_allocator() }
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence on many threads,
+ *     in buffer allocated with given allocator.
+ *
+ * **Example**
+ *
+ *     const auto out = input | tpl::sort(std::less<>(), tpl::par, arenaAllocator);
+ */
+template<
+	class Comparison,
+	class Allocator,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<!meta::is_materialization<Allocator>::value>::type
+>
+compare_factory<Comparison, basic_parallel_sort_policy<Allocator>, Materialization>
+sort(
+	Comparison &&comparison,
+	const parallel_factory &parallel,
+	const Allocator &allocator,
+	const Materialization & = Materialization()
+){
+	return compare_factory<Comparison, basic_parallel_sort_policy<Allocator>, Materialization>(
+		std::forward<Comparison>(comparison),
+		basic_parallel_sort_policy<Allocator>{ &parallel.chunk_executor(), parallel.concurrency(), allocator }
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence lazily.
+ *
+ * Result is the same as of sort, but begin() only builds a heap of elements
+ * and the following elements are extracted from it as the sequence is
+ * iterated, so consumers stopping after first k elements pay
+ * O(N + k log(N)) instead of O(N log(N)), without knowing k up front. If k
+ * is known, piping sort into tpl::take is cheaper still.
+ *
+ * This class **cannot** be used with infinite sequences.
+ *
+ * \tparam Comparison Type of function supplied to compare elements in input
+ *     sequence. It must follow strict weak ordering.
+ * \tparam Materialization Type of materialization mode. By default heap is
+ *     rebuilt on every call to begin().
+ *
+ * \param comparison Function-like object used to compare elements.
+ * \param materialization Materialization mode, tpl::rebuild_on_begin or
+ *     tpl::materialize_once.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 5, 3, 1, 2, 4 };
+ *     for (auto value : input | tpl::lazy_sort(std::less<>())) {
+ *         std::cout << value << ", ";//output will be 1, 2, 3,
+ *         if (value == 3)
+ *             break;// 4 and 5 are never ordered
+ *     }
+ */
+template<
+	class Comparison,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+compare_factory<Comparison, lazy_sort_policy, Materialization>
+lazy_sort(Comparison &&comparison, const Materialization & = Materialization()){
+	return compare_factory<Comparison, lazy_sort_policy, Materialization>(
+		std::forward<Comparison>(comparison)
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence lazily, in heap
+ *     allocated with given allocator.
+ *
+ * **Example**
+ *
+ *     const auto out = input | tpl::lazy_sort(std::less<>(), arenaAllocator);
+ */
+template<
+	class Comparison,
+	class Allocator,
+	class Materialization = rebuild_on_begin_t,
+	class = typename std::enable_if<!meta::is_materialization<Allocator>::value>::type
+>
+compare_factory<Comparison, basic_lazy_sort_policy<Allocator>, Materialization>
+lazy_sort(
+	Comparison &&comparison,
+	const Allocator &allocator,
+	const Materialization & = Materialization()
+){
+	return compare_factory<Comparison, basic_lazy_sort_policy<Allocator>, Materialization>(
+		std::forward<Comparison>(comparison),
+		basic_lazy_sort_policy<Allocator>{ allocator }
+	);
+}
+
+/**
+ * \brief Piping operator sorting input sequences which do not fit in memory.
+ *
+ * Input is read in runs taking at most memoryBudget bytes, as measured by
+ * sizeof of value_type. Each run is sorted and written to a temporary file in
+ * given directory, and iterating over the sequence merges the runs, keeping
+ * only one element of each run in memory. Input fitting in a single run is
+ * sorted in memory. Temporary files are removed when the sequence is
+ * destroyed or sorted again.
+ *
+ * Elements must be default constructible, and trivially copy constructible
+ * and destructible unless custom serializer is given.
+ *
+ * This class **cannot** be used with infinite sequences.
+ *
+ * **Complexity**
+ * - O(N log(M)) comparisons while sorting, where M is number of elements in
+ *   a run
+ * - O(log(R)) comparisons per element while iterating, where R is number of
+ *   runs
+ *
+ * \tparam Comparison Type of function supplied to compare elements in input
+ *     sequence. It must follow strict weak ordering.
+ * \tparam Serializer Type of serializer, see trivial_serializer.
+ *
+ * \param comparison Function-like object used to compare elements.
+ * \param memoryBudget Number of bytes of elements sorted in memory at once.
+ * \param directory Directory where temporary files are created.
+ * \param serializer Object writing elements to and reading them from files.
+ *
+ * **Example**
+ *
+ *     const auto out = events
+ *         | tpl::external_sort(byTimestamp, 1 << 30, "/tmp");
+ *     for (const auto &event : out) // runs are merged while iterating
+ *         process(event);
+ */
+template<class Comparison, class Serializer = trivial_serializer>
+compare_factory<Comparison, external_sort_policy<Serializer>>
+external_sort(
+	Comparison &&comparison,
+	std::size_t memoryBudget,
+	std::string directory,
+	Serializer serializer = Serializer()
+){
+	return compare_factory<Comparison, external_sort_policy<Serializer>>(
+		std::forward<Comparison>(comparison),
+		external_sort_policy<Serializer>{
+			memoryBudget,
+			std::move(directory),
+			std::move(serializer)
+		}
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence by keys computed
+ *     with given projection.
+ *
+ * Sequence is ordered as with `sort([](a, b){ return keyComparison(
+ * projection(a), projection(b)); })`, but projection is called only once per
+ * element, which pays off when computing keys is expensive. Keys and
+ * positions of elements are sorted together and then elements are moved to
+ * their sorted positions. Order of elements with equal keys is preserved.
+ *
+ * This class **cannot** be used with infinite sequences.
+ *
+ * **Complexity**
+ * - O(N log(N)) comparisons of keys
+ * - O(N) calls of projection
+ *
+ * \tparam Projection Type of function-like object taking element of input
+ *     sequence and returning its key.
+ * \tparam KeyComparison Type of function-like object comparing keys. It
+ *     must follow strict weak ordering.
+ *
+ * \param projection Function computing keys of elements.
+ * \param keyComparison Function comparing keys, by default std::less<>.
+ *
+ * **Example**
+ *
+ *     std::vector<std::string> input = { "b", "C", "a" };
+ *     const auto out = input | tpl::sort_by(to_lower);
+ *     // out is { "a", "b", "C" }
+ */
+template<class Projection, class KeyComparison = std::less<>>
+compare_factory<
+	detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+	decorated_sort_policy
+>
+sort_by(Projection &&projection, KeyComparison keyComparison = KeyComparison()){
+	return compare_factory<
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+		decorated_sort_policy
+	>(
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>(
+			std::forward<Projection>(projection),
+			std::move(keyComparison)
+		)
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence by keys computed
+ *     with given projection, allocating elements and keys with given
+ *     allocator.
+ *
+ * **Example**
+ *
+ *     const auto out = input | tpl::sort_by(to_lower, std::less<>(), arenaAllocator);
+ */
+template<class Projection, class KeyComparison, class Allocator>
+compare_factory<
+	detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+	basic_decorated_sort_policy<Allocator>
+>
+sort_by(Projection &&projection, KeyComparison keyComparison, const Allocator &allocator){
+	return compare_factory<
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+		basic_decorated_sort_policy<Allocator>
+	>(
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>(
+			std::forward<Projection>(projection),
+			std::move(keyComparison)
+		),
+		basic_decorated_sort_policy<Allocator>{ allocator }
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence by keys computed
+ *     with given projection, using radix sort for arithmetic keys.
+ *
+ * Sequence is ordered as with sort_by, but if keys are integers or floating
+ * point numbers and keyComparison is std::less or std::greater, elements are
+ * sorted with LSD radix sort.
+ *
+ * This class **cannot** be used with infinite sequences.
+ *
+ * **Complexity**
+ * - O(N * w) for radix sort, where w is width of the key in bytes
+ * - O(N log(N)) comparisons of keys otherwise
+ * - O(N) calls of projection
+ *
+ * \tparam Projection Type of function-like object taking element of input
+ *     sequence and returning its key.
+ * \tparam KeyComparison Type of function-like object comparing keys. It
+ *     must follow strict weak ordering.
+ *
+ * \param projection Function computing keys of elements.
+ * \param keyComparison Function comparing keys, by default std::less<>.
+ *
+ * **Example**
+ *
+ *     std::vector<std::pair<int, std::string>> input = { {3, "c"}, {1, "a"} };
+ *     const auto out = input
+ *         | tpl::sort_by_key([](const auto &p){ return p.first; });
+ *     // out is { {1, "a"}, {3, "c"} }
+ */
+template<class Projection, class KeyComparison = std::less<>>
+compare_factory<
+	detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+	key_sort_policy
+>
+sort_by_key(Projection &&projection, KeyComparison keyComparison = KeyComparison()){
+	return compare_factory<
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+		key_sort_policy
+	>(
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>(
+			std::forward<Projection>(projection),
+			std::move(keyComparison)
+		)
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence by keys computed
+ *     with given projection, using radix sort for arithmetic keys and
+ *     allocating all buffers with given allocator.
+ *
+ * **Example**
+ *
+ *     const auto out = input
+ *         | tpl::sort_by_key(byFirst, std::less<>(), arenaAllocator);
+ */
+template<class Projection, class KeyComparison, class Allocator>
+compare_factory<
+	detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+	basic_key_sort_policy<Allocator>
+>
+sort_by_key(Projection &&projection, KeyComparison keyComparison, const Allocator &allocator){
+	return compare_factory<
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>,
+		basic_key_sort_policy<Allocator>
+	>(
+		detail::key_comparison<typename std::decay<Projection>::type, KeyComparison>(
+			std::forward<Projection>(projection),
+			std::move(keyComparison)
+		),
+		basic_key_sort_policy<Allocator>{ allocator }
+	);
+}
+
+/**
+ * \brief Piping operator sorting elements in input sequence using default
+ *     sorting policy and given materialization mode.
+ *
+ * **Example**
+ *
+ *     std::vector<int> input = { 1, 3, 5, 2, 4 };
+ *     const auto out = input | tpl::sort(std::less<>(), tpl::materialize_once);
+ *     std::distance(out.begin(), out.end()); // sorts
+ *     for (auto value : out) // does not sort again
+ *         std::cout << value << ", ";//output will be 1, 2, 3, 4, 5,
  */
-template<class Comparison>
-compare_factory<Comparison>
-sort(Comparison &&comparison){
-	return compare_factory<Comparison>(std::forward<Comparison>(comparison));
+template<
+	class Comparison,
+	class Materialization,
+	class = typename std::enable_if<meta::is_materialization<Materialization>::value>::type
+>
+compare_factory<Comparison, contiguous_sort_policy, Materialization>
+sort(Comparison &&comparison, const Materialization &){
+	return compare_factory<Comparison, contiguous_sort_policy, Materialization>(
+		std::forward<Comparison>(comparison)
+	);
 }
 
 }
@@ -8,21 +8,92 @@
 #include "../meta/is_enumerable.hpp"
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
+
+#include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
+/**
+ * \brief Iterator counting down number of elements which are still to be taken.
+ *
+ * Iterator is equal to the end one when either the count reaches zero or the
+ * wrapped iterator reaches end of the wrapped sequence, so the length of the
+ * wrapped sequence is never measured. Wrapped iterator is not incremented past
+ * the last taken element, thus no surplus element is ever generated.
+ */
+template<class SubIterator>
+class taking_iterator :
+	public detail::input_iterator_base<taking_iterator<SubIterator>> {
+public:
+	using sub_traits_t = std::iterator_traits<SubIterator>;
+	using value_type = typename sub_traits_t::value_type;
+	using difference_type = typename sub_traits_t::difference_type;
+	using reference = typename sub_traits_t::reference;
+	using pointer = typename sub_traits_t::pointer;
+	using iterator_category = typename meta::demote_to_forward_tag<
+		sub_traits_t
+	>::type;
+
+	taking_iterator() = default;
+
+	~taking_iterator() noexcept = default;
+
+	taking_iterator(
+		SubIterator subIterator,
+		unsigned remaining
+	) :
+		m_subIterator(std::move(subIterator)),
+		m_remaining(remaining) {}
+
+	taking_iterator &
+	next() {
+		if (--m_remaining != 0)
+			++m_subIterator;
+		return *this;
+	}
+
+	reference
+	operator*() const {
+		return *m_subIterator;
+	}
+
+	pointer
+	operator->() const {
+		return m_subIterator.operator->();
+	}
+
+	bool
+	operator==(const taking_iterator &other) const {
+		return m_remaining == other.m_remaining ||
+			m_subIterator == other.m_subIterator;
+	}
+
+private:
+	SubIterator m_subIterator;
+	unsigned m_remaining = 0;
+};
+
 /**
  * \brief Sequence taking given number of elements from input sequence.
  *
  * This class can be safely used with infinite sequences. Actually, it is
  * designed to make finite sequences from infinite ones.
  *
+ * If the wrapped sequence has random access iterators, they are exposed
+ * directly. Otherwise taking_iterator is used, which stops after given number
+ * of elements without measuring the wrapped sequence.
+ *
  * This class complies with is_enumerable trait, which allows it to be used in
  * a pipeline.
  *
@@ -42,11 +113,25 @@ public:
 	 */
 	using value_type = typename enumerable_traits::value_type;
 
+private:
+	template<class SubIterator>
+	using is_random_access = meta::is_random_access_iterator<
+		std::iterator_traits<SubIterator>
+	>;
+
+	template<class SubIterator>
+	using taken_iterator_t = typename std::conditional<
+		is_random_access<SubIterator>::value,
+		SubIterator,
+		taking_iterator<SubIterator>
+	>::type;
+
+public:
 	//! Type of const_iterator.
-	using const_iterator = typename enumerable_traits::const_iterator;
+	using const_iterator = taken_iterator_t<typename enumerable_traits::const_iterator>;
 
 	//! Type of iterator.
-	using iterator = typename enumerable_traits::iterator;
+	using iterator = taken_iterator_t<typename enumerable_traits::iterator>;
 
 	/**
 	 * \brief Creates new taken_sequence from given sequence and number of
@@ -68,54 +153,170 @@ public:
 
 	/**
 	 * \brief Creates and returns iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * O(1)
 	 */
 	iterator
 	begin() {
-		return enumerable_traits::begin(m_enumerable);
+		return first(
+			enumerable_traits::begin(m_enumerable),
+			is_random_access<typename enumerable_traits::iterator>()
+		);
 	}
 
 	/**
 	 * \brief Creates and returns iterator pointing at the end.
+	 *
+	 * **Complexity**
+	 * O(1)
 	 */
 	iterator
 	end() {
-		return std::distance(enumerable_traits::begin(m_enumerable), enumerable_traits::end(m_enumerable)) > m_toTake ?
-			std::next(enumerable_traits::begin(m_enumerable), m_toTake) :
-			enumerable_traits::end(m_enumerable);
+		return last(
+			enumerable_traits::begin(m_enumerable),
+			enumerable_traits::end(m_enumerable),
+			is_random_access<typename enumerable_traits::iterator>()
+		);
 	}
 
 	/**
 	 * \brief Creates and returns const_iterator pointing at the begin.
+	 *
+	 * **Complexity**
+	 * O(1)
 	 */
 	const_iterator
 	begin() const {
-		return enumerable_traits::begin(m_enumerable);
+		return first(
+			enumerable_traits::begin(m_enumerable),
+			is_random_access<typename enumerable_traits::const_iterator>()
+		);
 	}
 
 	/**
 	 * \brief Creates and returns const_iterator pointing at the end.
+	 *
+	 * **Complexity**
+	 * O(1)
 	 */
 	const_iterator
 	end() const {
-		return std::distance(enumerable_traits::begin(m_enumerable), enumerable_traits::end(m_enumerable)) > m_toTake ?
-			std::next(enumerable_traits::begin(m_enumerable), m_toTake) :
-			enumerable_traits::end(m_enumerable);
+		return last(
+			enumerable_traits::begin(m_enumerable),
+			enumerable_traits::end(m_enumerable),
+			is_random_access<typename enumerable_traits::const_iterator>()
+		);
+	}
+
+	/**
+	 * \brief Pushes at most toTake elements to given callback until it returns
+	 *     false.
+	 *
+	 * Wrapped sequence is asked to stop right after the last taken element,
+	 * so this function can be safely used with infinite sequences.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		if (m_toTake == 0)
+			return true;
+
+		auto remaining = m_toTake;
+		bool wasStopped = false;
+		detail::for_each(m_enumerable, [&](const auto &value) {
+			if (!detail::invoke_callback(callback, value)) {
+				wasStopped = true;
+				return false;
+			}
+			return --remaining != 0;
+		});
+		return !wasStopped;
+	}
+
+	/**
+	 * \brief Returns number of elements, which is the smaller of number of
+	 *     elements to take and size of input sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return std::min<std::size_t>(meta::get_size(m_enumerable), m_toTake);
+	}
+
+	/**
+	 * \brief Returns size hint, clamped to number of elements to take.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::take_size_hint(meta::get_size_hint(m_enumerable), m_toTake);
 	}
 
 private:
+	template<class SubIterator>
+	SubIterator
+	first(SubIterator begin, std::true_type) const {
+		return begin;
+	}
+
+	template<class SubIterator>
+	taking_iterator<SubIterator>
+	first(SubIterator begin, std::false_type) const {
+		return taking_iterator<SubIterator>(std::move(begin), m_toTake);
+	}
+
+	template<class SubIterator>
+	SubIterator
+	last(SubIterator begin, SubIterator end, std::true_type) const {
+		using difference_type = typename std::iterator_traits<SubIterator>::difference_type;
+		return end - begin > static_cast<difference_type>(m_toTake) ?
+			begin + m_toTake :
+			end;
+	}
+
+	template<class SubIterator>
+	taking_iterator<SubIterator>
+	last(SubIterator, SubIterator end, std::false_type) const {
+		return taking_iterator<SubIterator>(std::move(end), 0);
+	}
+
 	Enumerable m_enumerable;
 	unsigned m_toTake;
 };
 
+/**
+ * \brief Creates sequence taking given number of elements from input sequence.
+ *
+ * This function is called unqualified by take_factory, so sequences which
+ * can produce their first elements cheaper than by full evaluation (e.g.
+ * sorted_sequence) may provide more specialized overload found by ADL.
+ */
+template<class Enumerable>
+taken_sequence<Enumerable>
+make_taken(Enumerable &&enumerable, unsigned toTake){
+	return taken_sequence<Enumerable>(
+		std::forward<Enumerable>(enumerable),
+		toTake
+	);
+}
+
 class take_factory {
 public:
 	explicit take_factory(unsigned toTake) :
 		m_toTake(toTake){}
 
 	template<class Enumerable>
-	taken_sequence<Enumerable>
-	create(Enumerable &&enumerable) const {
-		return taken_sequence<Enumerable>(
+	auto
+	create(Enumerable &&enumerable) const
+		-> decltype(make_taken(std::forward<Enumerable>(enumerable), 0u)) {
+		return make_taken(
 			std::forward<Enumerable>(enumerable),
 			m_toTake
 		);
@@ -9,22 +9,29 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
 
 #include "../detail/pointer_proxy.hpp"
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <type_traits>
+#include <cstddef>
 #include <functional>
 
 namespace tpl{
 
 template<class SubIterator, class Predicate>
 class transforming_iterator :
-	public detail::bidirectional_iterator_base<transforming_iterator<SubIterator, Predicate>> {
+	public detail::bidirectional_or_random_access_iterator_base<
+		transforming_iterator<SubIterator, Predicate>,
+		typename std::iterator_traits<SubIterator>::iterator_category,
+		typename std::iterator_traits<SubIterator>::difference_type
+	> {
 public:
 	using sub_traits_t = std::iterator_traits<SubIterator>;
 	using value_type = decltype(
@@ -35,9 +42,7 @@ public:
 	using difference_type = typename sub_traits_t::difference_type;
 	using reference = value_type;
 	using pointer = detail::pointer_proxy<value_type>;
-	using iterator_category = typename meta::demote_to_bidirectional_tag<
-		sub_traits_t
-	>::type;
+	using iterator_category = typename sub_traits_t::iterator_category;
 
 	transforming_iterator() = default;
 	transforming_iterator(const transforming_iterator &) = default;
@@ -69,6 +74,17 @@ public:
 		return *this;
 	}
 
+	transforming_iterator &
+	advance(difference_type offset) {
+		m_subIterator += offset;
+		return *this;
+	}
+
+	difference_type
+	distance_to(const transforming_iterator &other) const {
+		return other.m_subIterator - m_subIterator;
+	}
+
 	reference
 	operator*() const {
 		return (*m_transformPredicate)(*m_subIterator);
@@ -188,6 +204,42 @@ public:
 		return const_iterator(enumerable_traits::end(m_enumerable), m_predicate);
 	}
 
+	/**
+	 * \brief Pushes transformed elements to given callback until it returns
+	 *     false.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		return detail::for_each(m_enumerable, [this, &callback](const auto &value) {
+			return detail::invoke_callback(callback, m_predicate(value));
+		});
+	}
+
+	/**
+	 * \brief Returns number of elements, which is the same as in the transformed sequence.
+	 *
+	 * Available only if the wrapped sequence is an array or has size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E = Enumerable, class = typename std::enable_if<meta::has_size<E>::value>::type>
+	std::size_t
+	size() const {
+		return meta::get_size(m_enumerable);
+	}
+
+	/**
+	 * \brief Returns size hint, which is the same as of the transformed sequence.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::get_size_hint(m_enumerable);
+	}
+
 private:
 	Enumerable m_enumerable;
 	Predicate m_predicate;
@@ -8,31 +8,52 @@
 #include "../meta/is_associative.hpp"
 #include "../meta/enumerable_traits.hpp"
 #include "../meta/iterators.hpp"
+#include "../meta/size_hint.hpp"
 
 #include "../detail/pointer_proxy.hpp"
+#include "../detail/reference_pair.hpp"
 #include "../detail/iterator_base.hpp"
+#include "../detail/for_each.hpp"
 
 #include "../common/composite_factory.hpp"
 #include "../common/apply_operator.hpp"
 
 #include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 
 namespace tpl{
 
+/**
+ * Category of zipped_iterator is the weaker of categories of the wrapped
+ * iterators, e.g. random access only if both wrapped iterators are random
+ * access.
+ */
+template<class SubIterator1, class SubIterator2>
+using zipped_iterator_category = typename std::common_type<
+	typename std::iterator_traits<SubIterator1>::iterator_category,
+	typename std::iterator_traits<SubIterator2>::iterator_category
+>::type;
+
 template<class SubIterator1, class SubIterator2>
 class zipped_iterator :
-	public detail::bidirectional_iterator_base<zipped_iterator<SubIterator1, SubIterator2>> {
+	public detail::bidirectional_or_random_access_iterator_base<
+		zipped_iterator<SubIterator1, SubIterator2>,
+		zipped_iterator_category<SubIterator1, SubIterator2>,
+		typename std::iterator_traits<SubIterator1>::difference_type
+	> {
 public:
 	using sub_traits_t1 = std::iterator_traits<SubIterator1>;
 	using sub_traits_t2 = std::iterator_traits<SubIterator2>;
 	using value_type = std::pair<typename sub_traits_t1::value_type, typename sub_traits_t2::value_type>;
 	using difference_type = typename sub_traits_t1::difference_type;
-	using reference = value_type;
-	using pointer = detail::pointer_proxy<value_type>;
-	using iterator_category = typename meta::demote_to_bidirectional_tag<
-		sub_traits_t1
-	>::type;
+	using reference = detail::reference_pair<
+		typename sub_traits_t1::reference,
+		typename sub_traits_t2::reference
+	>;
+	using pointer = detail::pointer_proxy<reference>;
+	using iterator_category = zipped_iterator_category<SubIterator1, SubIterator2>;
 
 	zipped_iterator() = default;
 	zipped_iterator(const zipped_iterator &) = default;
@@ -66,16 +87,35 @@ public:
 		return *this;
 	}
 
+	zipped_iterator &
+	advance(difference_type offset) {
+		m_subIterator1 += offset;
+		m_subIterator2 += offset;
+		return *this;
+	}
+
+	/*
+	 * Zipped sequence ends with the shorter of wrapped sequences, so the
+	 * distance is the one of smaller magnitude.
+	 */
+	difference_type
+	distance_to(const zipped_iterator &other) const {
+		const difference_type distance1 = other.m_subIterator1 - m_subIterator1;
+		const difference_type distance2 = other.m_subIterator2 - m_subIterator2;
+		return (distance1 < 0 ? -distance1 : distance1) <
+			(distance2 < 0 ? -distance2 : distance2) ? distance1 : distance2;
+	}
+
+	// Elements are referenced in place, not copied, whenever wrapped
+	// iterators return references.
 	reference
 	operator*() const {
-		return std::make_pair(*m_subIterator1, *m_subIterator2);
+		return reference(*m_subIterator1, *m_subIterator2);
 	}
 
 	pointer
 	operator->() const {
-		return detail::make_pointer_proxy(
-			std::make_pair(*m_subIterator1, *m_subIterator2)
-		);
+		return detail::make_pointer_proxy(**this);
 	}
 
 	bool
@@ -92,6 +132,10 @@ private:
 /**
  * \brief Sequence zipping together two sequences.
  *
+ * Iterators return pairs of references to elements of zipped sequences, so
+ * no element is copied, unless a zipped sequence returns elements by value.
+ * Such pairs convert to value_type and compare with any std::pair.
+ *
  * This class can be safely used with infinite sequences.
  *
  * This class complies with is_enumerable trait, which allows it to be used in
@@ -186,6 +230,67 @@ public:
 		);
 	}
 
+	/**
+	 * \brief Pushes pairs of elements to given callback until it returns false
+	 *     or the shorter sequence ends.
+	 *
+	 * Elements of the first sequence are pushed, while the second one is
+	 * traversed with iterators. Like with iterators, pushed pairs reference
+	 * elements instead of copying them.
+	 *
+	 * \return false if iteration was stopped by the callback, true otherwise.
+	 */
+	template<class Callback>
+	bool
+	for_each(Callback &&callback) const {
+		using second_reference = typename std::iterator_traits<
+			typename enumerable_traits2::const_iterator
+		>::reference;
+
+		auto second = enumerable_traits2::begin(m_enumerable2);
+		const auto secondEnd = enumerable_traits2::end(m_enumerable2);
+		bool wasStopped = false;
+		detail::for_each(m_enumerable1, [&](const auto &value) {
+			if (second == secondEnd)
+				return false;
+
+			using pair_t = detail::reference_pair<decltype(value), second_reference>;
+			if (!detail::invoke_callback(callback, pair_t(value, *second))) {
+				wasStopped = true;
+				return false;
+			}
+
+			++second;
+			return true;
+		});
+		return !wasStopped;
+	}
+
+	/**
+	 * \brief Returns number of elements, which is the number of elements in the shorter of zipped sequences.
+	 *
+	 * Available only if both zipped sequences are arrays or have size().
+	 *
+	 * **Complexity**
+	 * O(1)
+	 */
+	template<class E1 = Enumerable1, class E2 = Enumerable2, class = typename std::enable_if<meta::has_size<E1>::value && meta::has_size<E2>::value>::type>
+	std::size_t
+	size() const {
+		return std::min(meta::get_size(m_enumerable1), meta::get_size(m_enumerable2));
+	}
+
+	/**
+	 * \brief Returns size hint, computed from hints of both zipped sequences.
+	 */
+	meta::size_hint
+	size_hint() const {
+		return meta::min_size_hint(
+			meta::get_size_hint(m_enumerable1),
+			meta::get_size_hint(m_enumerable2)
+		);
+	}
+
 private:
 	Enumerable1 m_enumerable1;
 	Enumerable2 m_enumerable2;
@@ -11,8 +11,14 @@
 #include "../common/apply_operator.hpp"
 
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/is_parallel.hpp"
+
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <type_traits>
 
 namespace tpl{
 
@@ -24,23 +30,52 @@ public:
 
 	bool
 	operator()(Enumerable &enumerable) {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::all_of(
-			traits::begin(enumerable),
-			traits::end(enumerable),
-			m_logicalPredicate
-		);
+		return all_matching(enumerable, m_logicalPredicate);
 	}
 
 	bool
 	operator()(const Enumerable &enumerable) const {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::all_of(traits::begin(enumerable), traits::end(enumerable),
-				m_logicalPredicate
-		);
+		return all_matching(enumerable, m_logicalPredicate);
 	}
 
 private:
+	template<class Predicate>
+	static bool
+	all_matching(const Enumerable &enumerable, Predicate &predicate) {
+		return all_matching(enumerable, predicate, meta::is_parallel<Enumerable>());
+	}
+
+	template<class Predicate>
+	static bool
+	all_matching(const Enumerable &enumerable, Predicate &predicate, std::false_type) {
+		bool wasViolated = false;
+		detail::for_each(enumerable, [&wasViolated, &predicate](const auto &value) {
+			wasViolated = !predicate(value);
+			return !wasViolated;
+		});
+		return !wasViolated;
+	}
+
+	// Chunks share the stop flag, so it has to be atomic only here.
+	template<class Predicate>
+	static bool
+	all_matching(const Enumerable &enumerable, Predicate &predicate, std::true_type) {
+		std::atomic<bool> wasViolated(false);
+		detail::reduce(
+			enumerable,
+			[&wasViolated, &predicate](const auto &chunk, bool) {
+				detail::for_each(chunk, [&wasViolated, &predicate](const auto &value) {
+					if (!predicate(value))
+						wasViolated = true;
+					return !wasViolated;
+				});
+				return true;
+			},
+			[](bool, bool) { return true; }
+		);
+		return !wasViolated;
+	}
+
 	LogicalPredicate m_logicalPredicate;
 };
 
@@ -11,8 +11,14 @@
 #include "../common/apply_operator.hpp"
 
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/is_parallel.hpp"
+
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <type_traits>
 
 namespace tpl{
 
@@ -24,21 +30,52 @@ public:
 
 	bool
 	operator()(Enumerable &enumerable) {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::any_of(traits::begin(enumerable), traits::end(enumerable),
-				m_logicalPredicate
-		);
+		return any_matching(enumerable, m_logicalPredicate);
 	}
 
 	bool
 	operator()(const Enumerable &enumerable) const {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::any_of(traits::begin(enumerable), traits::end(enumerable),
-				m_logicalPredicate
-		);
+		return any_matching(enumerable, m_logicalPredicate);
 	}
 
 private:
+	template<class Predicate>
+	static bool
+	any_matching(const Enumerable &enumerable, Predicate &predicate) {
+		return any_matching(enumerable, predicate, meta::is_parallel<Enumerable>());
+	}
+
+	template<class Predicate>
+	static bool
+	any_matching(const Enumerable &enumerable, Predicate &predicate, std::false_type) {
+		bool wasFound = false;
+		detail::for_each(enumerable, [&wasFound, &predicate](const auto &value) {
+			wasFound = predicate(value);
+			return !wasFound;
+		});
+		return wasFound;
+	}
+
+	// Chunks share the stop flag, so it has to be atomic only here.
+	template<class Predicate>
+	static bool
+	any_matching(const Enumerable &enumerable, Predicate &predicate, std::true_type) {
+		std::atomic<bool> wasFound(false);
+		detail::reduce(
+			enumerable,
+			[&wasFound, &predicate](const auto &chunk, bool) {
+				detail::for_each(chunk, [&wasFound, &predicate](const auto &value) {
+					if (predicate(value))
+						wasFound = true;
+					return !wasFound;
+				});
+				return true;
+			},
+			[](bool, bool) { return true; }
+		);
+		return wasFound;
+	}
+
 	LogicalPredicate m_logicalPredicate;
 };
 
@@ -11,7 +11,11 @@
 
 #include "../meta/enumerable_traits.hpp"
 
+#include "../detail/for_each.hpp"
+
 #include <algorithm>
+#include <iterator>
+#include <utility>
 
 namespace tpl{
 
@@ -32,8 +36,11 @@ public:
 template<class Enumerable, class OutputIterator>
 void
 copy_to_function(const Enumerable &enumerable, OutputIterator &&outputIterator){
-	using traits = meta::enumerable_traits<Enumerable>;
-	std::copy(traits::begin(enumerable), traits::end(enumerable), outputIterator);
+	auto output = outputIterator;
+	detail::for_each(enumerable, [&output](const auto &value) {
+		*output = value;
+		++output;
+	});
 }
 
 template<class OutputIterator>
@@ -12,6 +12,9 @@
 
 #include "../meta/enumerable_traits.hpp"
 
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
+
 #include <algorithm>
 
 namespace tpl{
@@ -24,27 +27,32 @@ public:
 
 	unsigned
 	operator()(Enumerable &enumerable) {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return static_cast<unsigned>(
-			std::count_if(
-				traits::begin(enumerable),
-				traits::end(enumerable),
-				m_logicalPredicate
-		));
+		return count_matching(enumerable, m_logicalPredicate);
 	}
 
 	unsigned
 	operator()(const Enumerable &enumerable) const {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return static_cast<unsigned>(
-				std::count_if(
-				traits::begin(enumerable),
-				traits::end(enumerable),
-				m_logicalPredicate
-		));
+		return count_matching(enumerable, m_logicalPredicate);
 	}
 
 private:
+	template<class Predicate>
+	static unsigned
+	count_matching(const Enumerable &enumerable, Predicate &predicate) {
+		return detail::reduce(
+			enumerable,
+			[&predicate](const auto &chunk, bool) {
+				unsigned result = 0;
+				detail::for_each(chunk, [&result, &predicate](const auto &value) {
+					if (predicate(value))
+						++result;
+				});
+				return result;
+			},
+			[](unsigned a, unsigned b) { return a + b; }
+		);
+	}
+
 	LogicalPredicate m_logicalPredicate;
 };
 
@@ -58,6 +58,9 @@ private:
  *     reduce or accumulate.
  *
  * This is a sink, which means it can be used as final part of a pipeline.
+ *
+ * If input sequence is marked with tpl::par, partial results of chunks are
+ * combined with predicate, so it must be associative.
  * 
  * In this version of sink default value of input sequence value_type is 
  * taken as initial fold value.
@@ -159,6 +162,13 @@ private:
  *     reduce or accumulate.
  *
  * This is a sink, which means it can be used as final part of a pipeline.
+ *
+ * If input sequence is marked with tpl::par, partial results of chunks are
+ * combined with predicate, so it must be associative. Chunks other than the
+ * first start from their first element instead of the initial value, so the
+ * fold runs in parallel only if elements are convertible to the type of the
+ * initial value and the predicate takes two values of that type. Otherwise it
+ * runs sequentially.
  * 
  * In this version of sink passed argument is taken as initial fold value.
  *
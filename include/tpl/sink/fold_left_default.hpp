@@ -3,6 +3,9 @@
 
 #include "../meta/enumerable_traits.hpp"
 
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
+
 #include <algorithm>
 #include <iterator>
 #include <numeric>
@@ -30,27 +33,66 @@ public:
 
 	conversion_type
 	operator()(Enumerable &enumerable) {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::accumulate(
-			traits::begin(enumerable),
-		   	traits::end(enumerable),
-		   	typename meta::enumerable_traits<Enumerable>::value_type(),
-			m_predicate
-		);
+		return accumulate(enumerable, m_predicate);
 	}
 
 	conversion_type
 	operator()(const Enumerable &enumerable) const{
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::accumulate(
-			traits::begin(enumerable),
-		   	traits::end(enumerable),
-		   	typename meta::enumerable_traits<Enumerable>::value_type(),
-			m_predicate
-		);
+		return accumulate(enumerable, m_predicate);
 	}
 
 private:
+	using value_type = typename meta::enumerable_traits<Enumerable>::value_type;
+
+	template<class Predicate>
+	static value_type
+	accumulate(const Enumerable &enumerable, Predicate &predicate) {
+		return accumulate(enumerable, predicate, meta::is_parallel<Enumerable>());
+	}
+
+	template<class Predicate>
+	static value_type
+	accumulate(const Enumerable &enumerable, Predicate &predicate, std::false_type) {
+		return fold(enumerable, value_type(), predicate);
+	}
+
+	template<class Predicate>
+	static value_type
+	accumulate(const Enumerable &enumerable, Predicate &predicate, std::true_type) {
+		return detail::reduce(
+			enumerable,
+			[&predicate](const auto &chunk, bool isLeading) {
+				return isLeading ?
+					fold(chunk, value_type(), predicate) :
+					fold_tail(chunk, predicate);
+			},
+			[&predicate](value_type accumulated, const value_type &partial) -> value_type {
+				return predicate(std::move(accumulated), partial);
+			}
+		);
+	}
+
+	template<class Chunk, class Predicate>
+	static value_type
+	fold(const Chunk &chunk, value_type accumulated, Predicate &predicate) {
+		detail::for_each(chunk, [&accumulated, &predicate](const auto &value) {
+			accumulated = predicate(accumulated, value);
+		});
+		return accumulated;
+	}
+
+	// Non-leading chunks of parallel fold start from their first element.
+	template<class Chunk, class Predicate>
+	static value_type
+	fold_tail(const Chunk &chunk, Predicate &predicate) {
+		auto first = std::begin(chunk);
+		const auto last = std::end(chunk);
+		value_type accumulated = *first;
+		for (++first; first != last; ++first)
+			accumulated = predicate(accumulated, *first);
+		return accumulated;
+	}
+
 	BinaryPredicate m_predicate;
 };
 
@@ -2,12 +2,42 @@
 #pragma once
 
 #include "../meta/enumerable_traits.hpp"
+#include "../meta/helpers.hpp"
+
+#include "../detail/for_each.hpp"
+#include "../detail/parallel_reduce.hpp"
 
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <type_traits>
 
 namespace tpl{
+namespace detail{
+
+/**
+ * Checks if fold with accumulator of type Accumulated can be split into
+ * chunks: non-leading chunks start from their first element, so it must be
+ * convertible to the accumulator, and partial results are combined with the
+ * predicate, so it must take two accumulators.
+ */
+template<class Element, class Accumulated, class Predicate, class = void>
+struct is_chunk_foldable : std::false_type {};
+
+template<class Element, class Accumulated, class Predicate>
+struct is_chunk_foldable<
+	Element,
+	Accumulated,
+	Predicate,
+	typename meta::type_sink<decltype(
+		std::declval<Accumulated>() = std::declval<Predicate &>()(
+			std::declval<Accumulated>(),
+			std::declval<const Accumulated &>()
+		)
+	)>::type
+> : std::is_convertible<Element, Accumulated> {};
+
+}
 
 template<
 	class Enumerable,
@@ -33,27 +63,74 @@ public:
 
 	conversion_type
 	operator()(const Enumerable &enumerable) const {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::accumulate(
-			traits::begin(enumerable),
-		   	traits::end(enumerable),
-		   	m_initialValue,
-		   	m_predicate
-		);
+		return accumulate(enumerable, m_initialValue, m_predicate);
 	}
 
 	conversion_type
 	operator()(Enumerable &enumerable) {
-		using traits = meta::enumerable_traits<Enumerable>;
-		return std::accumulate(
-			traits::begin(enumerable),
-		   	traits::end(enumerable),
-		   	m_initialValue,
-		   	m_predicate
-		);
+		return accumulate(enumerable, m_initialValue, m_predicate);
 	}
 
 private:
+	using accumulated_t = typename std::decay<InitialValue>::type;
+	using element_t = typename meta::enumerable_traits<Enumerable>::value_type;
+
+	// Folds which cannot be split into chunks run sequentially even if the
+	// sequence is marked with tpl::par.
+	template<class Predicate>
+	static accumulated_t
+	accumulate(const Enumerable &enumerable, const InitialValue &initialValue, Predicate &predicate) {
+		using is_parallel_t = std::integral_constant<
+			bool,
+			meta::is_parallel<Enumerable>::value &&
+				detail::is_chunk_foldable<element_t, accumulated_t, Predicate>::value
+		>;
+		return accumulate(enumerable, initialValue, predicate, is_parallel_t());
+	}
+
+	template<class Predicate>
+	static accumulated_t
+	accumulate(const Enumerable &enumerable, const InitialValue &initialValue, Predicate &predicate, std::false_type) {
+		return fold(enumerable, initialValue, predicate);
+	}
+
+	template<class Predicate>
+	static accumulated_t
+	accumulate(const Enumerable &enumerable, const InitialValue &initialValue, Predicate &predicate, std::true_type) {
+		return detail::reduce(
+			enumerable,
+			[&initialValue, &predicate](const auto &chunk, bool isLeading) {
+				return isLeading ?
+					fold(chunk, initialValue, predicate) :
+					fold_tail(chunk, predicate);
+			},
+			[&predicate](accumulated_t accumulated, const accumulated_t &partial) -> accumulated_t {
+				return predicate(std::move(accumulated), partial);
+			}
+		);
+	}
+
+	template<class Chunk, class Predicate>
+	static accumulated_t
+	fold(const Chunk &chunk, accumulated_t accumulated, Predicate &predicate) {
+		detail::for_each(chunk, [&accumulated, &predicate](const auto &value) {
+			accumulated = predicate(accumulated, value);
+		});
+		return accumulated;
+	}
+
+	// Non-leading chunks of parallel fold start from their first element.
+	template<class Chunk, class Predicate>
+	static accumulated_t
+	fold_tail(const Chunk &chunk, Predicate &predicate) {
+		auto first = std::begin(chunk);
+		const auto last = std::end(chunk);
+		accumulated_t accumulated = *first;
+		for (++first; first != last; ++first)
+			accumulated = predicate(accumulated, *first);
+		return accumulated;
+	}
+
 	BinaryPredicate m_predicate;
 	InitialValue m_initialValue;
 };
@@ -0,0 +1,118 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/operator/aggregated_by.hpp>
+#include <tpl/operator/grouped_by.hpp>
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <unordered_map>
+
+TEST_CASE( "Vector aggregation", "[aggregated_by_test]" ) {
+	std::vector<int> v{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	const auto isBig = [](const auto &i){ return i > 5; };
+	const auto sum = [](int accumulated, int i){ return accumulated + i; };
+
+	SECTION("Sum"){
+		const auto aggregated = v | tpl::aggregate_by(isBig, 0, sum);
+		std::unordered_map<bool, int> result(aggregated.begin(), aggregated.end());
+		std::unordered_map<bool, int> expected{ { true, 40 }, { false, 15 } };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Keys in order of first occurrence"){
+		const std::vector<int> input{ 3, 1, 3, 2, 1 };
+		const auto count = input | tpl::aggregate_by(
+			[](int i){ return i; },
+			std::size_t(0),
+			[](std::size_t n, int){ return n + 1; }
+		);
+		std::vector<std::pair<int, std::size_t>> result(count.begin(), count.end());
+		const std::vector<std::pair<int, std::size_t>> expected{ { 3, 2 }, { 1, 2 }, { 2, 1 } };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Accumulator of different type than elements"){
+		const auto joined = v | tpl::aggregate_by(
+			[](int i){ return i % 3; },
+			std::string(),
+			[](std::string s, int i){ return s + std::to_string(i); }
+		);
+		std::unordered_map<int, std::string> result(joined.begin(), joined.end());
+		std::unordered_map<int, std::string> expected{
+			{ 0, "369" }, { 1, "14710" }, { 2, "258" }
+		};
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Empty input"){
+		const std::vector<int> empty;
+		const auto aggregated = empty | tpl::aggregate_by(isBig, 0, sum);
+		REQUIRE(aggregated.begin() == aggregated.end());
+	}
+
+	SECTION("Size hint"){
+		const auto aggregated = v | tpl::aggregate_by(isBig, 0, sum);
+		REQUIRE(aggregated.size_hint() == tpl::meta::size_hint::upper_bound(10));
+	}
+}
+
+TEST_CASE( "Aggregation matches grouping", "[aggregated_by_test]" ) {
+	std::vector<int> v;
+	for (int i = 0; i < 100000; ++i)
+		v.push_back((i * 7919) % 30011);
+	const auto key = [](int i){ return i % 1009; };
+	const auto sum = [](long long accumulated, int i){ return accumulated + i; };
+
+	std::unordered_map<int, long long> expected;
+	for (const auto &group : v | tpl::group_by(key))
+		expected[group.first] = std::accumulate(group.second.begin(), group.second.end(), 0ll);
+
+	SECTION("Flat backend"){
+		const auto aggregated = v | tpl::aggregate_by(key, 0ll, sum);
+		std::unordered_map<int, long long> result(aggregated.begin(), aggregated.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Unordered map backend"){
+		const auto aggregated = v | tpl::aggregate_by(key, 0ll, sum, tpl::unordered_map_grouping);
+		std::unordered_map<int, long long> result(aggregated.begin(), aggregated.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Push-based iteration"){
+		const auto aggregated = v | tpl::aggregate_by(key, 0ll, sum);
+		std::unordered_map<int, long long> result;
+		aggregated.for_each([&result](const auto &pair){ result.insert(pair); });
+		REQUIRE(expected == result);
+	}
+}
+
+TEST_CASE( "Aggregation materialization", "[aggregated_by_test]" ) {
+	std::vector<int> v{ 1, 2, 3 };
+	const auto isOdd = [](int i){ return i % 2 == 1; };
+	const auto sum = [](int accumulated, int i){ return accumulated + i; };
+
+	SECTION("Rebuilt on begin by default"){
+		const auto aggregated = v | tpl::aggregate_by(isOdd, 0, sum);
+		aggregated.begin();
+		v = { 5 };
+		std::unordered_map<bool, int> result(aggregated.begin(), aggregated.end());
+		std::unordered_map<bool, int> expected{ { true, 5 } };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Stale until refreshed"){
+		const auto aggregated = v | tpl::aggregate_by(isOdd, 0, sum, tpl::materialize_once);
+		aggregated.begin();
+		v = { 5 };
+		std::unordered_map<bool, int> stale(aggregated.begin(), aggregated.end());
+		std::unordered_map<bool, int> expected{ { true, 4 }, { false, 2 } };
+		REQUIRE(expected == stale);
+
+		aggregated.refresh();
+		std::unordered_map<bool, int> refreshed(aggregated.begin(), aggregated.end());
+		REQUIRE((std::unordered_map<bool, int>{ { true, 5 } } == refreshed));
+	}
+}
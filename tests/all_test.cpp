@@ -26,4 +26,10 @@ TEST_CASE( "All in vector", "[all_test]" ) {
 		const bool result = (v | all([](const auto &i){ return i < 5; }));
 		REQUIRE(false == result);
 	}
+	SECTION("Stops at first violation"){
+		int checked = 0;
+		const bool result = (v | all([&checked](const auto &i){ ++checked; return i < 5; }));
+		REQUIRE(false == result);
+		REQUIRE(5 == checked);
+	}
 }
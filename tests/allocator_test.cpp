@@ -0,0 +1,313 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/operator/cached.hpp>
+#include <tpl/operator/memoized.hpp>
+#include <tpl/operator/sorted.hpp>
+#include <tpl/operator/grouped_by.hpp>
+#include <tpl/operator/aggregated_by.hpp>
+#include <tpl/operator/take.hpp>
+#include <tpl/generator/generator.hpp>
+#include <tpl/executor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace tpl;
+
+namespace {
+
+// Stateful allocator without default constructor, counting live allocations
+// in counter shared by all its copies and rebinds.
+template<class T>
+class counting_allocator {
+public:
+	using value_type = T;
+
+	explicit counting_allocator(size_t *allocations) :
+		m_allocations(allocations) {}
+
+	template<class U>
+	counting_allocator(const counting_allocator<U> &other) :
+		m_allocations(other.allocations()) {}
+
+	T *
+	allocate(size_t n) {
+		++*m_allocations;
+		return allocator<T>().allocate(n);
+	}
+
+	void
+	deallocate(T *p, size_t n) {
+		--*m_allocations;
+		allocator<T>().deallocate(p, n);
+	}
+
+	size_t *
+	allocations() const {
+		return m_allocations;
+	}
+
+	template<class U>
+	bool
+	operator==(const counting_allocator<U> &other) const {
+		return m_allocations == other.allocations();
+	}
+
+	template<class U>
+	bool
+	operator!=(const counting_allocator<U> &other) const {
+		return !(*this == other);
+	}
+
+private:
+	size_t *m_allocations;
+};
+
+}
+
+TEST_CASE( "Caching with allocator", "[allocator_test]" ) {
+	size_t allocations = 0;
+	const counting_allocator<char> arena(&allocations);
+	vector<int> in = { 3, 1, 2 };
+
+	SECTION("Cached elements are allocated with given allocator") {
+		{
+			const auto cached = in | cache(arena);
+			REQUIRE(allocations == 0u);
+			REQUIRE(vector<int>(cached.begin(), cached.end()) == in);
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Allocator is kept with synchronization mode") {
+		const auto cached = in | cache(thread_safe, arena);
+		REQUIRE(vector<int>(cached.begin(), cached.end()) == in);
+		REQUIRE(allocations > 0u);
+	}
+
+	SECTION("Copy of cached sequence uses the same allocator") {
+		const auto cached = in | cache(arena);
+		const auto copy = cached;
+		REQUIRE(vector<int>(copy.begin(), copy.end()) == in);
+		REQUIRE(allocations > 0u);
+	}
+}
+
+TEST_CASE( "Memoizing with allocator", "[allocator_test]" ) {
+	size_t allocations = 0;
+	const counting_allocator<char> arena(&allocations);
+	{
+		const auto memoized = generator([](auto i){ return i + 1; }, 0)
+			| memoize(arena);
+		const auto first = memoized | take(3);
+		REQUIRE(vector<int>(first.begin(), first.end()) == (vector<int>{ 0, 1, 2 }));
+		REQUIRE(allocations > 0u);
+	}
+	REQUIRE(allocations == 0u);
+}
+
+TEST_CASE( "Sorting with allocator", "[allocator_test]" ) {
+	size_t allocations = 0;
+	const counting_allocator<char> arena(&allocations);
+	vector<int> in = { 5, 1, 4, 2, 3 };
+	const vector<int> expected = { 1, 2, 3, 4, 5 };
+
+	SECTION("Contiguous buffer") {
+		{
+			const auto sorted = in | sort(less<>(), contiguous_sort(arena));
+			REQUIRE(vector<int>(sorted.begin(), sorted.end()) == expected);
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Multiset") {
+		{
+			const auto sorted = in | sort(less<>(), multiset_sort(arena));
+			REQUIRE(vector<int>(sorted.begin(), sorted.end()) == expected);
+			REQUIRE(allocations == in.size());
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Materialized once") {
+		const auto sorted = in | sort(less<>(), contiguous_sort(arena), materialize_once);
+		REQUIRE(vector<int>(sorted.begin(), sorted.end()) == expected);
+		REQUIRE(allocations > 0u);
+	}
+
+	SECTION("Followed by take") {
+		{
+			const auto taken = in | sort(less<>(), contiguous_sort(arena)) | take(2);
+			REQUIRE(vector<int>(taken.begin(), taken.end()) == (vector<int>{ 1, 2 }));
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Lazily") {
+		{
+			const auto sorted = in | lazy_sort(less<>(), arena);
+			REQUIRE(vector<int>(sorted.begin(), sorted.end()) == expected);
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("By projection") {
+		vector<int> many(1000);
+		iota(many.rbegin(), many.rend(), 0);
+		const auto identity = [](int i){ return i; };
+		{
+			const auto byKey = many | sort_by_key(identity, less<>(), arena);
+			const auto byProjection = many | sort_by(identity, less<>(), arena);
+			REQUIRE(is_sorted(byKey.begin(), byKey.end()));
+			REQUIRE(is_sorted(byProjection.begin(), byProjection.end()));
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("On executor") {
+		executor pool(2);
+		vector<int> many(10000);
+		iota(many.rbegin(), many.rend(), 0);
+		{
+			const auto sorted = many | sort(less<>(), par(pool)(4), arena);
+			REQUIRE(is_sorted(sorted.begin(), sorted.end()));
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+}
+
+TEST_CASE( "Grouping with allocator", "[allocator_test]" ) {
+	size_t allocations = 0;
+	const counting_allocator<char> arena(&allocations);
+	vector<int> in = { 1, 2, 3, 4, 5, 6 };
+	const auto parity = [](int i){ return i % 2; };
+	const map<int, vector<int>> expected = {
+		{ 0, { 2, 4, 6 } },
+		{ 1, { 1, 3, 5 } }
+	};
+
+	SECTION("Flat hash table") {
+		{
+			const auto grouped = in | group_by(parity, flat_hash_grouping(arena));
+			map<int, vector<int>> out;
+			for (const auto &group : grouped)
+				out[group.first].assign(group.second.begin(), group.second.end());
+			REQUIRE(out == expected);
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Unordered map") {
+		{
+			const auto grouped = in | group_by(parity, unordered_map_grouping(arena));
+			map<int, vector<int>> out;
+			for (const auto &group : grouped)
+				out[group.first].assign(group.second.begin(), group.second.end());
+			REQUIRE(out == expected);
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("On executor") {
+		executor pool(2);
+		vector<int> many(10000);
+		iota(many.begin(), many.end(), 0);
+		{
+			const auto grouped = many | group_by(parity, par(pool)(4), arena);
+			map<int, size_t> sizes;
+			for (const auto &group : grouped)
+				sizes[group.first] = group.second.size();
+			REQUIRE((sizes == map<int, size_t>{ { 0, 5000 }, { 1, 5000 } }));
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+
+	SECTION("Aggregation") {
+		{
+			const auto sums = in | aggregate_by(
+				parity,
+				0,
+				[](int sum, int i){ return sum + i; },
+				flat_hash_grouping(arena)
+			);
+			map<int, int> out(sums.begin(), sums.end());
+			REQUIRE((out == map<int, int>{ { 0, 12 }, { 1, 9 } }));
+			REQUIRE(allocations > 0u);
+		}
+		REQUIRE(allocations == 0u);
+	}
+}
+
+TEST_CASE( "Flat hash map with allocators", "[allocator_test]" ) {
+	using map_t = detail::flat_hash_map<
+		int,
+		int,
+		hash<int>,
+		equal_to<int>,
+		counting_allocator<pair<const int, int>>
+	>;
+	size_t sourceAllocations = 0;
+	size_t targetAllocations = 0;
+	const map_t::allocator_type sourceArena(&sourceAllocations);
+	const map_t::allocator_type targetArena(&targetAllocations);
+
+	SECTION("Copy keeps allocator of the source") {
+		map_t source(sourceArena);
+		for (int i = 0; i < 100; ++i)
+			source[i] = i;
+		const map_t copy = source;
+		REQUIRE(copy.get_allocator() == sourceArena);
+		REQUIRE(copy.size() == 100);
+	}
+
+	SECTION("Copy assignment keeps allocator of the target") {
+		{
+			map_t target(targetArena);
+			{
+				map_t source(sourceArena);
+				for (int i = 0; i < 100; ++i)
+					source[i] = i;
+				target = source;
+			}
+			REQUIRE(sourceAllocations == 0u);
+			REQUIRE(target.get_allocator() == targetArena);
+			REQUIRE(target.size() == 100);
+			REQUIRE(target.find(42)->second == 42);
+		}
+		REQUIRE(targetAllocations == 0u);
+	}
+
+	SECTION("Move assignment keeps allocator of the target") {
+		{
+			map_t target(targetArena);
+			{
+				map_t source(sourceArena);
+				for (int i = 0; i < 100; ++i)
+					source[i] = i;
+				target = std::move(source);
+			}
+			REQUIRE(sourceAllocations == 0u);
+			REQUIRE(target.get_allocator() == targetArena);
+			REQUIRE(target.size() == 100);
+			REQUIRE(target.find(42)->second == 42);
+		}
+		REQUIRE(targetAllocations == 0u);
+	}
+}
@@ -26,4 +26,10 @@ TEST_CASE( "Any in vector", "[any_test]" ) {
 		const bool result = v | any([](const auto &i){ return i < 5; });
 		REQUIRE(true == result);
 	}
+	SECTION("Stops at first match"){
+		int checked = 0;
+		const bool result = v | any([&checked](const auto &i){ ++checked; return i > 4; });
+		REQUIRE(true == result);
+		REQUIRE(5 == checked);
+	}
 }
@@ -2,9 +2,13 @@
 #include <catch.hpp>
 
 #include <tpl/operator/cached.hpp>
+#include <tpl/operator/transformed.hpp>
 
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -25,3 +29,43 @@ TEST_CASE( "Testing caching", "[cache_test]" ) {
 		REQUIRE(out2 == expected2);
 	}
 }
+
+TEST_CASE( "Thread safe caching", "[cache_test]" ) {
+	vector<int> in(10000);
+	for (int i = 0; i < 10000; ++i)
+		in[static_cast<size_t>(i)] = i;
+	atomic<int> computed{ 0 };
+	const auto counted = in | transform([&computed](int i){ ++computed; return 2 * i; });
+
+	SECTION("Filled once by many threads") {
+		const auto shared = counted | cache(thread_safe);
+		vector<long long> sums(8);
+		vector<thread> threads;
+		for (size_t t = 0; t != sums.size(); ++t)
+			threads.emplace_back([&shared, &sums, t]{
+				sums[t] = accumulate(shared.begin(), shared.end(), 0ll);
+			});
+		for (auto &worker : threads)
+			worker.join();
+
+		REQUIRE(computed == 10000);
+		for (auto sum : sums)
+			REQUIRE(sum == 99990000ll);
+		REQUIRE(shared.size_hint() == meta::size_hint::exact(10000));
+	}
+
+	SECTION("Copies keep filled cache") {
+		const auto shared = counted | cache(thread_safe);
+		shared.begin();
+		const auto copy = shared;
+		REQUIRE(copy.size() == 10000);
+		REQUIRE(computed == 10000);
+	}
+
+	SECTION("Single threaded mode is the default") {
+		const auto single = counted | cache(single_threaded);
+		const vector<int> out(single.begin(), single.end());
+		REQUIRE(out.size() == 10000);
+		REQUIRE(computed == 10000);
+	}
+}
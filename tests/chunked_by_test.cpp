@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/operator/chunked_by.hpp>
+#include <tpl/operator/take.hpp>
+#include <tpl/generator/generator.hpp>
+
+#include <vector>
+#include <list>
+#include <string>
+#include <utility>
+
+template<class Runs>
+std::vector<std::pair<int, std::vector<int>>>
+collect(const Runs &runs) {
+	std::vector<std::pair<int, std::vector<int>>> result;
+	for (const auto &run : runs)
+		result.emplace_back(run.first, std::vector<int>(run.second.begin(), run.second.end()));
+	return result;
+}
+
+TEST_CASE( "Vector chunking", "[chunked_by_test]" ) {
+	using namespace tpl;
+	std::vector<int> v{ 1, 1, 2, 3, 3, 3, 1 };
+	const auto identity = [](int i){ return i; };
+
+	SECTION("Runs of equal keys"){
+		const auto runs = v | chunk_by(identity);
+		const std::vector<std::pair<int, std::vector<int>>> expected{
+			{ 1, { 1, 1 } }, { 2, { 2 } }, { 3, { 3, 3, 3 } }, { 1, { 1 } }
+		};
+		REQUIRE(expected == collect(runs));
+	}
+
+	SECTION("Runs view input in place"){
+		const auto runs = v | chunk_by(identity);
+		auto run = runs.begin();
+		++run;
+		++run;
+		REQUIRE(run->second.size() == 3);
+		REQUIRE(&*run->second.begin() == &v[3]);
+	}
+
+	SECTION("Key of the run"){
+		const auto runs = v | chunk_by([](int i){ return i % 2 == 1; });
+		const std::vector<std::pair<int, std::vector<int>>> expected{
+			{ 1, { 1, 1 } }, { 0, { 2 } }, { 1, { 3, 3, 3, 1 } }
+		};
+		REQUIRE(expected == collect(runs));
+	}
+
+	SECTION("Empty input"){
+		const std::vector<int> empty;
+		const auto runs = empty | chunk_by(identity);
+		REQUIRE(runs.begin() == runs.end());
+	}
+
+	SECTION("Size hint"){
+		const auto runs = v | chunk_by(identity);
+		REQUIRE(runs.size_hint() == meta::size_hint::upper_bound(7));
+	}
+
+	SECTION("Push-based iteration"){
+		const auto runs = v | chunk_by(identity);
+		std::vector<std::size_t> sizes;
+		runs.for_each([&sizes](const auto &run){ sizes.push_back(run.second.size()); });
+		REQUIRE((std::vector<std::size_t>{ 2, 1, 3, 1 }) == sizes);
+	}
+
+	SECTION("Keys are computed once per element"){
+		unsigned keys = 0;
+		const auto runs = v | chunk_by([&keys](int i){ ++keys; return i; });
+		std::vector<int> runKeys;
+		for (auto run = runs.begin(); run != runs.end(); ++run) {
+			runKeys.push_back((*run).first);
+			REQUIRE(run->first == runKeys.back());
+		}
+		REQUIRE((std::vector<int>{ 1, 2, 3, 1 }) == runKeys);
+		REQUIRE(keys == v.size());
+	}
+}
+
+TEST_CASE( "List chunking", "[chunked_by_test]" ) {
+	using namespace tpl;
+	const std::list<std::string> l{ "apple", "avocado", "banana", "cherry", "cranberry" };
+	const auto runs = l | chunk_by([](const std::string &s){ return s.front(); });
+	std::vector<std::pair<char, std::size_t>> result;
+	for (const auto &run : runs)
+		result.emplace_back(run.first, run.second.size());
+	REQUIRE((std::vector<std::pair<char, std::size_t>>{ { 'a', 2 }, { 'b', 1 }, { 'c', 2 } }) == result);
+}
+
+TEST_CASE( "Infinite chunking", "[chunked_by_test]" ) {
+	using namespace tpl;
+	unsigned computed = 0;
+	const auto runs = generator([](int i){ return i + 1; }, 0)
+		| chunk_by([&computed](int i){ ++computed; return i / 3; })
+		| take(3);
+
+	const std::vector<std::pair<int, std::vector<int>>> expected{
+		{ 0, { 0, 1, 2 } }, { 1, { 3, 4, 5 } }, { 2, { 6, 7, 8 } }
+	};
+	REQUIRE(expected == collect(runs));
+	REQUIRE(computed < 30u);
+}
@@ -28,3 +28,12 @@ TEST_CASE( "Copying into a vector", "[copy_to_test]" ) {
 		REQUIRE(in == out);
 	}
 }
+
+TEST_CASE( "Appending repeatedly to a vector", "[copy_to_test]" ) {
+	const vector<int> in { 1, 2, 3 };
+	vector<int> out;
+	for (int i = 0; i < 1000; ++i)
+		in | copy_to(std::back_inserter(out));
+	REQUIRE(out.size() == 3000u);
+	REQUIRE((vector<int>(out.end() - 3, out.end()) == in));
+}
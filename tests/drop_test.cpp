@@ -2,9 +2,15 @@
 #include <catch.hpp>
 
 #include <tpl/operator/drop.hpp>
+#include <tpl/operator/filtered.hpp>
+#include <tpl/operator/take.hpp>
+#include <tpl/operator/sorted.hpp>
+#include <tpl/generator/generator.hpp>
 
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <list>
 #include <vector>
 #include <iostream>
 
@@ -33,3 +39,54 @@ TEST_CASE( "Testing droping from sequence", "[drop_test]" ) {
 		REQUIRE(out2 == vector<int>());
 	}
 }
+
+TEST_CASE( "Dropping from sequences without random access", "[drop_test]" ) {
+	SECTION("Drop from list") {
+		const list<int> in = { 1, 2, 3, 4 };
+		const auto result = in | drop(2);
+		const auto result2 = in | drop(6);
+		REQUIRE((vector<int>{ 3, 4 }) == vector<int>(result.begin(), result.end()));
+		REQUIRE(result2.begin() == result2.end());
+	}
+
+	SECTION("Drop from generator") {
+		unsigned generated = 0;
+		const auto result = generator([&generated](int i){ ++generated; return i + 1; }, 0) |
+			filter([](int i){ return i % 2 == 0; }) |
+			drop(2) |
+			take(3);
+		REQUIRE((vector<int>{ 4, 6, 8 }) == vector<int>(result.begin(), result.end()));
+		const auto afterFirst = generated;
+		REQUIRE(4 == *result.begin());
+		REQUIRE(afterFirst == generated);
+	}
+
+	SECTION("Refresh after change") {
+		list<int> in = { 1, 2, 3 };
+		const auto result = in | drop(1);
+		REQUIRE(2 == *result.begin());
+		in.pop_front();
+		result.refresh();
+		REQUIRE((vector<int>{ 3 }) == vector<int>(result.begin(), result.end()));
+	}
+}
+
+TEST_CASE( "Dropping with mixed const and non-const begin", "[drop_test]" ) {
+	const vector<int> in = { 5, 2, 8, 1, 6 };
+
+	SECTION("Wrapped sequence rebuilt on begin") {
+		auto result = in | sort(std::less<>(), multiset_sort) | drop(2);
+		result.begin();
+		static_cast<const decltype(result) &>(result).begin();
+		REQUIRE((vector<int>{ 5, 6, 8 }) == vector<int>(result.begin(), result.end()));
+	}
+
+	SECTION("Wrapped sequence materialized once") {
+		auto result = in | sort(std::less<>(), multiset_sort, materialize_once) | drop(2);
+		result.begin();
+		static_cast<const decltype(result) &>(result).begin();
+		REQUIRE((vector<int>{ 5, 6, 8 }) == vector<int>(result.begin(), result.end()));
+		const auto &constView = result;
+		REQUIRE((vector<int>{ 5, 6, 8 }) == vector<int>(constView.begin(), constView.end()));
+	}
+}
@@ -0,0 +1,89 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/executor.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace tpl;
+
+TEST_CASE( "Executor workers", "[executor_test]" ) {
+	REQUIRE(executor(0).worker_count() == 0);
+	REQUIRE(executor(3).worker_count() == 3);
+	REQUIRE(&default_executor() == &default_executor());
+}
+
+TEST_CASE( "Parallel for", "[executor_test]" ) {
+	executor pool(3);
+	vector<atomic<int>> visits(1000);
+	for (auto &visit : visits)
+		visit = 0;
+
+	SECTION("Each index is visited once"){
+		pool.parallel_for(0, visits.size(), 7, [&visits](size_t first, size_t last) {
+			REQUIRE(last - first <= 7);
+			for (; first != last; ++first)
+				++visits[first];
+		});
+		for (const auto &visit : visits)
+			REQUIRE(visit == 1);
+	}
+
+	SECTION("Nested loops"){
+		pool.parallel_for(0, 10, 1, [&pool, &visits](size_t outer, size_t) {
+			pool.parallel_for(0, 100, 3, [&visits, outer](size_t first, size_t last) {
+				for (; first != last; ++first)
+					++visits[outer * 100 + first];
+			});
+		});
+		for (const auto &visit : visits)
+			REQUIRE(visit == 1);
+	}
+
+	SECTION("Executor without workers"){
+		executor inline_pool(0);
+		inline_pool.parallel_for(0, visits.size(), 10, [&visits](size_t first, size_t last) {
+			for (; first != last; ++first)
+				++visits[first];
+		});
+		for (const auto &visit : visits)
+			REQUIRE(visit == 1);
+	}
+}
+
+TEST_CASE( "Fork join", "[executor_test]" ) {
+	executor pool(1);
+
+	SECTION("Forked task is stolen by idle worker"){
+		atomic<int> started(0);
+		const auto meet = [&started]() {
+			++started;
+			const auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+			while (started < 2 && chrono::steady_clock::now() < deadline)
+				this_thread::yield();
+		};
+		pool.fork_join(meet, meet);
+		REQUIRE(started == 2);
+	}
+
+	SECTION("Exceptions are rethrown after both tasks finish"){
+		atomic<bool> isRightDone(false);
+		REQUIRE_THROWS_AS(
+			pool.fork_join(
+				[]() { throw runtime_error("left"); },
+				[&isRightDone]() { isRightDone = true; }
+			),
+			const runtime_error &
+		);
+		REQUIRE(isRightDone);
+		REQUIRE_THROWS_AS(
+			pool.fork_join([]() {}, []() { throw runtime_error("right"); }),
+			const runtime_error &
+		);
+	}
+}
@@ -2,11 +2,14 @@
 #include <catch.hpp>
 
 #include <tpl/operator/filtered.hpp>
+#include <tpl/operator/sorted.hpp>
 
 #include <vector>
 #include <list>
 #include <utility>
 #include <forward_list>
+#include <iterator>
+#include <functional>
 
 TEST_CASE( "Vector filtering", "[filtered_test]" ) {
 	using namespace std;
@@ -132,3 +135,58 @@ TEST_CASE( "Meta tests", "[filtered_test]" ) {
 		REQUIRE((std::is_same<decltype(it2)::iterator_category, std::forward_iterator_tag>::value));
 	}
 }
+
+TEST_CASE( "Caching begin position", "[filtered_test]" ) {
+	std::vector<int> v(100, 0);
+	v.back() = 1;
+	unsigned calls = 0;
+	const auto vf = v | tpl::filter([&calls](int i){ ++calls; return i == 1; });
+
+	SECTION("Repeated begin"){
+		REQUIRE(*vf.begin() == 1);
+		const auto afterFirst = calls;
+		REQUIRE(afterFirst == 100);
+		REQUIRE(*vf.begin() == 1);
+		REQUIRE(*vf.begin() == 1);
+		REQUIRE(calls == afterFirst);
+	}
+
+	SECTION("Refresh after change"){
+		REQUIRE(*vf.begin() == 1);
+		v.front() = 1;
+		v.back() = 2;
+		vf.refresh();
+		REQUIRE(vf.begin() == std::prev(vf.end()));
+		REQUIRE(&*vf.begin() == &v.front());
+	}
+
+	SECTION("Copies search again"){
+		const auto copy = vf;
+		REQUIRE(&*copy.begin() == &v.back());
+	}
+}
+
+TEST_CASE( "Mixing const and non-const begin", "[filtered_test]" ) {
+	using namespace std;
+	using namespace tpl;
+	const vector<int> v{ 5, 2, 8, 1, 6 };
+	const auto isEven = [](int i){ return i % 2 == 0; };
+
+	SECTION("Wrapped sequence rebuilt on begin"){
+		REQUIRE(meta::rebuilds_on_begin<decltype(v | sort(less<>(), multiset_sort))>::value);
+		auto vf = v | sort(less<>(), multiset_sort) | filter(isEven);
+		vf.begin();
+		static_cast<const decltype(vf) &>(vf).begin();
+		REQUIRE((vector<int>(vf.begin(), vf.end()) == vector<int>{ 2, 6, 8 }));
+	}
+
+	SECTION("Wrapped sequence materialized once"){
+		REQUIRE_FALSE(meta::rebuilds_on_begin<decltype(v | sort(less<>(), materialize_once))>::value);
+		auto vf = v | sort(less<>(), multiset_sort, materialize_once) | filter(isEven);
+		vf.begin();
+		static_cast<const decltype(vf) &>(vf).begin();
+		REQUIRE((vector<int>(vf.begin(), vf.end()) == vector<int>{ 2, 6, 8 }));
+		const auto &constView = vf;
+		REQUIRE((vector<int>(constView.begin(), constView.end()) == vector<int>{ 2, 6, 8 }));
+	}
+}
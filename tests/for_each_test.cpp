@@ -0,0 +1,85 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/detail/for_each.hpp>
+#include <tpl/operator.hpp>
+#include <tpl/generator.hpp>
+#include <tpl/sink.hpp>
+#include <tpl/operator/reverse.hpp>
+#include <tpl/operator/grouped_by.hpp>
+
+#include <list>
+#include <map>
+#include <vector>
+
+using namespace std;
+using namespace tpl;
+
+template<class Enumerable>
+auto
+pushed(const Enumerable &enumerable) {
+	vector<std::remove_cv_t<typename iterator_traits<decltype(enumerable.begin())>::value_type>> result;
+	REQUIRE(enumerable.for_each([&result](const auto &value) { result.push_back(value); }));
+	return result;
+}
+
+TEST_CASE( "Detecting push-based iteration", "[for_each_test]" ) {
+	const vector<int> v{ 1, 2, 3 };
+	const auto filtered = v | filter([](int){ return true; });
+	REQUIRE_FALSE(meta::has_for_each<vector<int>>::value);
+	REQUIRE(meta::has_for_each<decltype(filtered)>::value);
+	REQUIRE(meta::has_for_each<decltype(infinite(1))>::value);
+}
+
+TEST_CASE( "Pushing elements through operators", "[for_each_test]" ) {
+	const vector<int> v{ 1, 2, 3, 4, 5, 6 };
+	const auto isEven = [](int i){ return i % 2 == 0; };
+	const auto square = [](int i){ return i * i; };
+
+	SECTION("Same elements as iterators"){
+		const auto chain = v | filter(isEven) | transform(square);
+		REQUIRE(pushed(chain) == vector<int>(chain.begin(), chain.end()));
+		REQUIRE(pushed(v | drop(2) | take(3)) == (vector<int>{ 3, 4, 5 }));
+		REQUIRE(pushed(v | tpl::reverse) == (vector<int>{ 6, 5, 4, 3, 2, 1 }));
+		REQUIRE(pushed(v | sort(std::greater<>()) | take(2)) == (vector<int>{ 6, 5 }));
+		REQUIRE(pushed(v | cache) == v);
+		REQUIRE(pushed(vector<vector<int>>{ { 1 }, {}, { 2, 3 } } | flatten) == (vector<int>{ 1, 2, 3 }));
+		REQUIRE(pushed(map<int, int>{ { 1, 2 }, { 3, 4 } } | keys) == (vector<int>{ 1, 3 }));
+		REQUIRE(pushed(map<int, int>{ { 1, 2 }, { 3, 4 } } | mapped_values) == (vector<int>{ 2, 4 }));
+		REQUIRE(pushed(v | zip(list<int>{ 7, 8 })) == (vector<pair<int, int>>{ { 1, 7 }, { 2, 8 } }));
+		REQUIRE(pushed(v | group_by(isEven)).size() == 2);
+	}
+
+	SECTION("Stopping early"){
+		vector<int> result;
+		const bool wasCompleted = (v | transform(square)).for_each([&result](int value) {
+			result.push_back(value);
+			return value < 9;
+		});
+		REQUIRE_FALSE(wasCompleted);
+		REQUIRE(result == (vector<int>{ 1, 4, 9 }));
+	}
+
+	SECTION("Taking from infinite generators"){
+		unsigned generated = 0;
+		const auto numbers = generator([&generated](int i){ ++generated; return i + 1; }, 0);
+		REQUIRE(pushed(numbers | filter(isEven) | take(3)) == (vector<int>{ 0, 2, 4 }));
+		REQUIRE(generated == 4);
+		REQUIRE(pushed(cycle(vector<int>{ 1, 2 }) | take(5)) == (vector<int>{ 1, 2, 1, 2, 1 }));
+		REQUIRE(pushed(infinite(7) | take(2)) == (vector<int>{ 7, 7 }));
+	}
+}
+
+TEST_CASE( "Sinks over pushing sequences", "[for_each_test]" ) {
+	const auto numbers = generator([](int i){ return i + 1; }, 1) | take(10);
+	REQUIRE(static_cast<unsigned>(numbers | count([](int i){ return i > 5; })) == 5);
+	REQUIRE(static_cast<int>(numbers | fold_left([](int a, int b){ return a + b; })) == 55);
+	REQUIRE(static_cast<int>(numbers | fold_left([](int a, int b){ return a + b; }, 5)) == 60);
+	REQUIRE(static_cast<bool>(numbers | all([](int i){ return i > 0; })));
+	REQUIRE_FALSE(static_cast<bool>(numbers | any([](int i){ return i > 10; })));
+	REQUIRE(static_cast<bool>(generator([](int i){ return i + 1; }, 1) | any([](int i){ return i == 100; })));
+
+	vector<int> out;
+	numbers | copy_to(std::back_inserter(out));
+	REQUIRE(out == (vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+}
@@ -2,10 +2,14 @@
 #include <catch.hpp>
 
 #include <tpl/operator/grouped_by.hpp>
+#include <tpl/operator/transformed.hpp>
+#include <tpl/executor.hpp>
 
 #include <vector>
+#include <list>
 #include <unordered_map>
 #include <algorithm>
+#include <string>
 
 TEST_CASE( "Vector grouping", "[grouped_by_test]" ) {
 	std::vector<int> v{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
@@ -44,3 +48,197 @@ TEST_CASE( "Vector grouping", "[grouped_by_test]" ) {
 		REQUIRE(expected == result);
 	}
 }
+
+TEST_CASE( "Grouping materialization", "[grouped_by_test]" ) {
+	std::vector<int> v{ 1, 2, 3 };
+	const auto isOdd = [](const auto &i){ return i % 2 == 1; };
+
+	SECTION("Rebuilt on begin by default"){
+		const auto grouped = v | tpl::group_by(isOdd);
+		grouped.begin();
+		v = { 5 };
+		std::unordered_map<bool, std::vector<int>> result(
+			grouped.begin(),
+			grouped.end()
+		);
+		std::unordered_map<bool, std::vector<int>> expected{ { true, { 5 } } };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Stale until refreshed"){
+		const auto grouped = v | tpl::group_by(isOdd, tpl::materialize_once);
+		grouped.begin();
+		v = { 5 };
+		std::unordered_map<bool, std::vector<int>> stale(
+			grouped.begin(),
+			grouped.end()
+		);
+		std::unordered_map<bool, std::vector<int>> expected{
+			{ true, { 1, 3 } },
+			{ false, { 2 } }
+		};
+		REQUIRE(expected == stale);
+
+		grouped.refresh();
+		std::unordered_map<bool, std::vector<int>> refreshed(
+			grouped.begin(),
+			grouped.end()
+		);
+		expected = { { true, { 5 } } };
+		REQUIRE(expected == refreshed);
+	}
+}
+
+TEST_CASE( "Grouping computed elements", "[grouped_by_test]" ) {
+	const std::vector<int> v{ 1, 2, 3, 4, 5, 6, 7 };
+	unsigned reads = 0;
+	const auto counted = v | tpl::transform([&reads](int i){ ++reads; return i; });
+	const auto parity = [](int i){ return i % 2; };
+
+	SECTION("Flat hash table"){
+		const auto grouped = counted | tpl::group_by(parity);
+		REQUIRE(grouped.begin() != grouped.end());
+		REQUIRE(reads == v.size());
+	}
+
+	SECTION("Unordered map"){
+		const auto grouped = counted | tpl::group_by(parity, tpl::unordered_map_grouping);
+		REQUIRE(grouped.begin() != grouped.end());
+		REQUIRE(reads == v.size());
+	}
+}
+
+TEST_CASE( "Grouping backends", "[grouped_by_test]" ) {
+	std::vector<int> v;
+	for (int i = 0; i < 100000; ++i)
+		v.push_back((i * 7919) % 30011);
+	const auto identity = [](int i){ return i; };
+
+	SECTION("Backends produce the same groups"){
+		const auto flat = v | tpl::group_by(identity);
+		const auto node = v | tpl::group_by(identity, tpl::unordered_map_grouping);
+		const auto once = v | tpl::group_by(identity, tpl::flat_hash_grouping, tpl::materialize_once);
+		std::unordered_map<int, std::vector<int>> fromFlat(flat.begin(), flat.end());
+		std::unordered_map<int, std::vector<int>> fromNode(node.begin(), node.end());
+		std::unordered_map<int, std::vector<int>> fromOnce(once.begin(), once.end());
+		REQUIRE(fromFlat.size() == 30011);
+		REQUIRE(fromFlat == fromNode);
+		REQUIRE(fromFlat == fromOnce);
+	}
+
+	SECTION("Flat backend keeps order of first occurrence"){
+		const std::vector<int> small{ 3, 1, 3, 2, 1 };
+		const auto grouped = small | tpl::group_by(identity);
+		std::vector<std::pair<int, std::vector<int>>> result(grouped.begin(), grouped.end());
+		const std::vector<std::pair<int, std::vector<int>>> expected{
+			{ 3, { 3, 3 } }, { 1, { 1, 1 } }, { 2, { 2 } }
+		};
+		REQUIRE(expected == result);
+	}
+}
+
+struct colliding_hash {
+	std::size_t operator()(int i) const { return static_cast<std::size_t>(i % 3); }
+};
+
+TEST_CASE( "Flat hash map", "[grouped_by_test]" ) {
+	tpl::detail::flat_hash_map<int, int, colliding_hash> map;
+	REQUIRE(map.empty());
+	REQUIRE(map.find(1) == map.end());
+
+	for (int i = 0; i < 1000; ++i)
+		map[i] += i;
+	for (int i = 0; i < 1000; ++i)
+		map[i] += 1;
+	REQUIRE(map.size() == 1000);
+	for (int i = 0; i < 1000; ++i) {
+		REQUIRE(map.count(i) == 1);
+		REQUIRE(map.find(i)->second == i + 1);
+	}
+	REQUIRE(map.count(1000) == 0);
+	REQUIRE(map.begin()->first == 0);
+
+	map.clear();
+	REQUIRE(map.empty());
+	REQUIRE(map.count(5) == 0);
+	map.reserve(10);
+	map[5] = 7;
+	REQUIRE(map.find(5)->second == 7);
+}
+
+TEST_CASE( "Parallel grouping", "[grouped_by_test]" ) {
+	std::vector<int> v;
+	for (int i = 0; i < 100000; ++i)
+		v.push_back((i * 7919) % 30011);
+	const auto key = [](int i){ return i % 1009; };
+	const auto sequential = v | tpl::group_by(key);
+	const std::vector<std::pair<int, std::vector<int>>> expected(sequential.begin(), sequential.end());
+	tpl::executor pool(3);
+
+	SECTION("Same groups in the same order as sequential grouping"){
+		const auto grouped = v | tpl::group_by(key, tpl::par(pool)(4));
+		const std::vector<std::pair<int, std::vector<int>>> result(grouped.begin(), grouped.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Result does not depend on number of chunks"){
+		for (unsigned concurrency : { 1u, 2u, 3u, 7u, 16u }) {
+			const auto grouped = v | tpl::group_by(key, tpl::par(pool)(concurrency));
+			const std::vector<std::pair<int, std::vector<int>>> result(grouped.begin(), grouped.end());
+			REQUIRE(expected == result);
+		}
+	}
+
+	SECTION("Materialized once"){
+		const auto grouped = v | tpl::group_by(key, tpl::par(pool), tpl::materialize_once);
+		grouped.begin();
+		v.clear();
+		const std::vector<std::pair<int, std::vector<int>>> result(grouped.begin(), grouped.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Sequential fallback for other sequences"){
+		const std::list<int> l(v.begin(), v.end());
+		const auto grouped = l | tpl::group_by(key, tpl::par(pool));
+		const std::vector<std::pair<int, std::vector<int>>> result(grouped.begin(), grouped.end());
+		REQUIRE(expected == result);
+	}
+}
+
+struct copy_counter {
+	explicit copy_counter(int *counter) : copies(counter) {}
+	copy_counter(const copy_counter &other) : copies(other.copies) { ++*copies; }
+	copy_counter(copy_counter &&other) noexcept : copies(other.copies) {}
+	copy_counter &operator=(const copy_counter &) = default;
+	copy_counter &operator=(copy_counter &&) = default;
+
+	int *copies;
+};
+
+TEST_CASE( "Flat hash map keeps entries in place", "[grouped_by_test]" ) {
+	int copies = 0;
+	tpl::detail::flat_hash_map<std::string, copy_counter> map;
+	map.emplace("first", &copies);
+	const copy_counter *const first = &map.find("first")->second;
+
+	for (int i = 0; i < 1000; ++i)
+		map.emplace(std::to_string(i), &copies);
+	REQUIRE(map.size() == 1001);
+	REQUIRE(copies == 0);
+	REQUIRE(&map.find("first")->second == first);
+
+	SECTION("Copy of the map holds the same entries"){
+		const auto copy = map;
+		REQUIRE(copy.size() == 1001);
+		REQUIRE(copy.count("999") == 1);
+		REQUIRE(copy.begin()->first == "first");
+	}
+
+	SECTION("Cleared map is reused"){
+		map.clear();
+		REQUIRE(map.empty());
+		map.emplace("second", &copies);
+		REQUIRE(map.begin()->first == "second");
+		REQUIRE(copies == 0);
+	}
+}
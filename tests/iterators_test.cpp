@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <list>
+#include <iterator>
 
 using namespace tpl::meta;
 
@@ -16,3 +17,9 @@ TEST_CASE( "Check created iterator traits", "[iterator_test]" ) {
 	REQUIRE((std::is_same<typename demote_to_input_tag<std::vector<int>::iterator>::type, std::input_iterator_tag>::value));
 	REQUIRE((std::is_same<typename demote_to_input_tag<std::list<int>::iterator>::type, std::input_iterator_tag>::value));
 }
+
+TEST_CASE( "Check forward demotion", "[iterator_test]" ) {
+	REQUIRE((std::is_same<typename demote_to_forward_tag<std::vector<int>::iterator>::type, std::forward_iterator_tag>::value));
+	REQUIRE((std::is_same<typename demote_to_forward_tag<std::list<int>::iterator>::type, std::forward_iterator_tag>::value));
+	REQUIRE((std::is_same<typename demote_to_forward_tag<std::istream_iterator<int>>::type, std::input_iterator_tag>::value));
+}
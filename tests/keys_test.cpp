@@ -2,10 +2,14 @@
 #include <catch.hpp>
 
 #include <tpl/operator/keys.hpp>
+#include <tpl/operator/zipped.hpp>
 
 #include <vector>
 #include <string>
 #include <map>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 TEST_CASE( "Keys", "[keys_test]" ) {
 	using namespace std;
@@ -58,3 +62,48 @@ TEST_CASE( "Compilation tests", "[keys_test]" ) {
 		REQUIRE((tpl::keys_iterator<map<string, string>::iterator>() == stringMapIterator));
 	}
 }
+
+TEST_CASE( "Keys iterator category", "[keys_test]" ) {
+	using namespace std;
+	using namespace tpl;
+
+	SECTION("Random access"){
+		const vector<pair<int, string>> v{ {1, "a"}, {2, "b"}, {3, "c"} };
+		const auto vf = v | keys;
+		REQUIRE((is_same<
+			iterator_traits<decltype(vf.begin())>::iterator_category,
+			random_access_iterator_tag
+		>::value));
+		REQUIRE(vf.end() - vf.begin() == 3);
+		REQUIRE(vf.begin()[2] == 3);
+	}
+
+	SECTION("Bidirectional"){
+		const map<int, int> m{ {1, 2}, {3, 4} };
+		const auto vf = m | keys;
+		REQUIRE(*std::prev(vf.end()) == 3);
+		REQUIRE(*--std::next(vf.begin()) == 1);
+	}
+}
+
+TEST_CASE( "Keys without copies", "[keys_test]" ) {
+	using namespace std;
+	using namespace tpl;
+
+	SECTION("Keys held in place are referenced"){
+		const map<string, int> m{ {"a", 1}, {"b", 2} };
+		const auto vf = m | keys;
+		REQUIRE((is_same<decltype(*vf.begin()), const string &>::value));
+		REQUIRE(&*vf.begin() == &m.begin()->first);
+		REQUIRE(vf.begin()->size() == 1u);
+		REQUIRE((is_same<iterator_traits<decltype(vf.begin())>::value_type, string>::value));
+	}
+
+	SECTION("Computed keys are returned by value"){
+		const vector<int> k{ 1, 2 };
+		const vector<string> v{ "a", "b" };
+		const auto vf = k | zip(v) | keys;
+		REQUIRE((is_same<decltype(*vf.begin()), int>::value));
+		REQUIRE((vector<int>(vf.begin(), vf.end()) == k));
+	}
+}
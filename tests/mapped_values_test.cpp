@@ -2,8 +2,15 @@
 #include <catch.hpp>
 
 #include <tpl/operator/mapped_values.hpp>
+#include <tpl/operator/grouped_by.hpp>
+#include <tpl/operator/zipped.hpp>
 
 #include <vector>
+#include <map>
+#include <string>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 TEST_CASE( "Keys", "[keys_test]" ) {
 	using namespace std;
@@ -56,3 +63,49 @@ TEST_CASE( "Compilation tests", "[mapped_values_test]" ) {
 				stringMapIterator));
 	}
 }
+
+TEST_CASE( "Mapped values iterator category", "[mapped_values_test]" ) {
+	using namespace std;
+	using namespace tpl;
+
+	const vector<pair<int, int>> v{ {1, 2}, {3, 4}, {5, 6} };
+	const auto vf = v | mapped_values;
+	REQUIRE((is_same<
+		iterator_traits<decltype(vf.begin())>::iterator_category,
+		random_access_iterator_tag
+	>::value));
+	REQUIRE(vf.end() - vf.begin() == 3);
+	REQUIRE(*(vf.begin() + 1) == 4);
+}
+
+TEST_CASE( "Mapped values without copies", "[mapped_values_test]" ) {
+	using namespace std;
+	using namespace tpl;
+
+	SECTION("Values held in place are referenced"){
+		const map<int, string> m{ {1, "a"}, {2, "bc"} };
+		const auto vf = m | mapped_values;
+		REQUIRE((is_same<decltype(*vf.begin()), const string &>::value));
+		REQUIRE(&*vf.begin() == &m.begin()->second);
+		REQUIRE(std::next(vf.begin())->size() == 2u);
+	}
+
+	SECTION("Groups are not copied"){
+		const vector<int> v{ 1, 2, 3, 4, 5 };
+		const auto grouped = v
+			| group_by([](int i){ return i % 2; }, materialize_once);
+		const auto groups = grouped | mapped_values;
+		const auto &first = *groups.begin();
+		REQUIRE(&first == &grouped.begin()->second);
+		REQUIRE((first == vector<int>{ 1, 3, 5 }));
+	}
+
+	SECTION("Computed values are returned by value"){
+		const vector<int> k{ 1, 2 };
+		const vector<string> v{ "a", "bc" };
+		const auto vf = k | zip(v) | mapped_values;
+		REQUIRE((is_same<decltype(*vf.begin()), string>::value));
+		REQUIRE(std::next(vf.begin())->size() == 2u);
+		REQUIRE((vector<string>(vf.begin(), vf.end()) == v));
+	}
+}
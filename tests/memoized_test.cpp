@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/operator/memoized.hpp>
+#include <tpl/operator/transformed.hpp>
+#include <tpl/operator/take.hpp>
+#include <tpl/generator/generator.hpp>
+#include <tpl/generator/cycle.hpp>
+
+#include <vector>
+#include <list>
+
+using namespace std;
+using namespace tpl;
+
+TEST_CASE( "Vector memoization", "[memoized_test]" ) {
+	vector<int> in = { 1, 2, 3, 4, 5 };
+	unsigned computed = 0;
+	const auto memoized = in
+		| transform([&computed](int i){ ++computed; return i * i; })
+		| memoize;
+
+	SECTION("Nothing is read on begin") {
+		memoized.begin();
+		memoized.end();
+		REQUIRE(computed == 0u);
+		REQUIRE(memoized.memoized_count() == 0u);
+	}
+
+	SECTION("Elements are read once") {
+		const vector<int> first(memoized.begin(), memoized.end());
+		const vector<int> second(memoized.begin(), memoized.end());
+		REQUIRE(first == (vector<int>{ 1, 4, 9, 16, 25 }));
+		REQUIRE(first == second);
+		REQUIRE(computed == 5u);
+	}
+
+	SECTION("Only the prefix visited by iterators is read") {
+		auto it = memoized.begin();
+		REQUIRE(*it == 1);
+		++it;
+		REQUIRE(*it == 4);
+		REQUIRE(computed == 2u);
+
+		auto other = memoized.begin();
+		REQUIRE(*++other == 4);
+		REQUIRE(&*other == &*it);
+		REQUIRE(computed == 2u);
+	}
+
+	SECTION("Push-based iteration shares the prefix") {
+		*memoized.begin();
+		vector<int> out;
+		memoized.for_each([&out](int i){ out.push_back(i); return i < 9; });
+		REQUIRE(out == (vector<int>{ 1, 4, 9 }));
+		REQUIRE(computed == 3u);
+	}
+
+	SECTION("Size hint") {
+		REQUIRE(memoized.size_hint() == meta::size_hint::exact(5));
+	}
+
+	SECTION("Empty input") {
+		const vector<int> empty;
+		const auto result = empty | memoize;
+		REQUIRE(result.begin() == result.end());
+	}
+}
+
+TEST_CASE( "Infinite memoization", "[memoized_test]" ) {
+	unsigned computed = 0;
+	const auto memoized = generator([](int i){ return i + 1; }, 0)
+		| transform([&computed](int i){ ++computed; return 2 * i; })
+		| memoize;
+
+	SECTION("Prefix of generator") {
+		const auto first = memoized | take(4);
+		const vector<int> out(first.begin(), first.end());
+		REQUIRE(out == (vector<int>{ 0, 2, 4, 6 }));
+		const auto longer = memoized | take(6);
+		const vector<int> out2(longer.begin(), longer.end());
+		REQUIRE(out2 == (vector<int>{ 0, 2, 4, 6, 8, 10 }));
+		REQUIRE(computed == 6u);
+	}
+
+	SECTION("Cycle") {
+		const list<int> l{ 1, 2 };
+		const auto repeated = cycle(l) | memoize | take(5);
+		const vector<int> out(repeated.begin(), repeated.end());
+		REQUIRE(out == (vector<int>{ 1, 2, 1, 2, 1 }));
+	}
+}
@@ -0,0 +1,75 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/executor.hpp>
+#include <tpl/operator/parallel.hpp>
+#include <tpl/operator/transformed.hpp>
+#include <tpl/operator/filtered.hpp>
+#include <tpl/sink.hpp>
+
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace tpl;
+
+TEST_CASE( "Parallel sinks", "[parallel_test]" ) {
+	vector<int> v(10000);
+	iota(v.begin(), v.end(), 0);
+	const auto isEven = [](int i){ return i % 2 == 0; };
+
+	SECTION("Same results as sequential sinks"){
+		REQUIRE(static_cast<unsigned>(v | par(4) | count(isEven)) == 5000);
+		REQUIRE(static_cast<bool>(v | par(4) | any([](int i){ return i == 9999; })));
+		REQUIRE_FALSE(static_cast<bool>(v | par(4) | any([](int i){ return i < 0; })));
+		REQUIRE(static_cast<bool>(v | par(4) | all([](int i){ return i >= 0; })));
+		REQUIRE_FALSE(static_cast<bool>(v | par(4) | all([](int i){ return i != 5000; })));
+		REQUIRE(static_cast<long>(v | transform([](int i){ return long(i); }) | par(4) | fold_left(std::plus<>())) == 49995000);
+		REQUIRE(static_cast<long>(v | transform([](int i){ return long(i); }) | par(4) | fold_left(std::plus<>(), 5L)) == 49995005);
+	}
+
+	SECTION("Order of elements is kept"){
+		const auto digits = v | transform([](int i){ return to_string(i % 10); });
+		const string sequential = digits | fold_left(std::plus<>());
+		const string parallel = digits | par(4) | fold_left(std::plus<>());
+		REQUIRE(sequential.size() == 10000);
+		REQUIRE(parallel == sequential);
+	}
+
+	SECTION("Upstream stages run on executor"){
+		executor pool(3);
+		mutex idsMutex;
+		set<thread::id> ids;
+		const auto recorded = v | transform([&idsMutex, &ids](int i){
+			lock_guard<mutex> lock(idsMutex);
+			ids.insert(this_thread::get_id());
+			return i;
+		});
+		REQUIRE(static_cast<unsigned>(recorded | par(pool) | count(isEven)) == 5000);
+		REQUIRE(static_cast<unsigned>(recorded | par(pool)(8) | count(isEven)) == 5000);
+		REQUIRE(ids.size() >= 1);
+		REQUIRE(ids.size() <= 4);
+	}
+
+	SECTION("Short and non random access sequences"){
+		const vector<int> shortVector{ 1, 2, 3 };
+		REQUIRE(static_cast<int>(shortVector | par | fold_left(std::plus<>())) == 6);
+		REQUIRE(static_cast<unsigned>(v | filter(isEven) | par(4) | count([](int i){ return i > 100; })) == 4949);
+		REQUIRE(static_cast<int>(vector<int>() | par(4) | fold_left(std::plus<>(), 7)) == 7);
+	}
+
+	SECTION("Accumulator of other type than elements"){
+		const auto words = v | transform([](int i){ return to_string(i); });
+		const auto addLength = [](size_t length, const auto &word) -> size_t {
+			return length + word.size();
+		};
+		REQUIRE(static_cast<size_t>(words | par(4) | fold_left(addLength, size_t(0))) == 38890);
+		REQUIRE(static_cast<size_t>(words | par(4) | fold_left(addLength, size_t(0))) ==
+			static_cast<size_t>(words | fold_left(addLength, size_t(0))));
+	}
+}
@@ -0,0 +1,136 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <catch.hpp>
+
+#include <tpl/meta/size_hint.hpp>
+#include <tpl/operator.hpp>
+#include <tpl/generator.hpp>
+#include <tpl/operator/reverse.hpp>
+#include <tpl/operator/grouped_by.hpp>
+#include <tpl/sink/copy_to.hpp>
+
+#include <forward_list>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace tpl;
+using meta::size_hint;
+using meta::get_size_hint;
+
+TEST_CASE( "Size hints of containers", "[size_hint_test]" ) {
+	const int array[4] = { 1, 2, 3, 4 };
+	REQUIRE(get_size_hint(vector<int>(3)) == size_hint::exact(3));
+	REQUIRE(get_size_hint(list<int>(2)) == size_hint::exact(2));
+	REQUIRE(get_size_hint(array) == size_hint::exact(4));
+	REQUIRE(get_size_hint(forward_list<int>(2)) == size_hint::unknown());
+
+	REQUIRE(meta::has_size<vector<int>>::value);
+	REQUIRE(meta::has_size<int (&)[4]>::value);
+	REQUIRE_FALSE(meta::has_size<forward_list<int>>::value);
+}
+
+TEST_CASE( "Size hints of sequences", "[size_hint_test]" ) {
+	const vector<int> v{ 1, 2, 3, 4, 5, 6 };
+	const list<int> l{ 1, 2, 3 };
+	const auto identity = [](int i){ return i; };
+	const auto isOdd = [](int i){ return i % 2 == 1; };
+
+	SECTION("Preserved exactly"){
+		REQUIRE((v | transform(identity)).size() == 6);
+		REQUIRE((v | tpl::reverse).size() == 6);
+		REQUIRE((v | sort(std::less<>())).size() == 6);
+		REQUIRE((map<int, int>{ {1, 2}, {3, 4} } | keys).size() == 2);
+		REQUIRE((map<int, int>{ {1, 2}, {3, 4} } | mapped_values).size() == 2);
+		REQUIRE((v | zip(l)).size() == 3);
+		REQUIRE((v | zip(l)).size_hint() == size_hint::exact(3));
+		REQUIRE(get_size_hint(v | transform(identity) | tpl::reverse) == size_hint::exact(6));
+	}
+
+	SECTION("Clamped by take and drop"){
+		REQUIRE((v | take(4)).size() == 4);
+		REQUIRE((v | take(10)).size() == 6);
+		REQUIRE((v | drop(4)).size() == 2);
+		REQUIRE((v | drop(10)).size() == 0);
+		REQUIRE((v | sort(std::less<>()) | take(2)).size_hint() == size_hint::exact(2));
+		REQUIRE((infinite(1) | take(5)).size_hint() == size_hint::exact(5));
+		REQUIRE((infinite(1) | drop(5)).size_hint() == size_hint::infinite());
+	}
+
+	SECTION("Bounded by filter"){
+		REQUIRE((v | filter(isOdd)).size_hint() == size_hint::upper_bound(6));
+		REQUIRE((v | filter(isOdd) | take(2)).size_hint() == size_hint::upper_bound(2));
+		REQUIRE((v | filter(isOdd) | drop(2)).size_hint() == size_hint::upper_bound(4));
+		REQUIRE((v | group_by(isOdd)).size_hint() == size_hint::upper_bound(6));
+		REQUIRE((generator([](int i){ return i + 1; }, 0) | filter(isOdd)).size_hint() ==
+				size_hint::unknown());
+		REQUIRE((generator([](int i){ return i + 1; }, 0) | filter(isOdd) | take(3)).size_hint() ==
+				size_hint::upper_bound(3));
+	}
+
+	SECTION("Exact after caching"){
+		const auto cached = v | filter(isOdd) | cache;
+		REQUIRE(cached.size_hint() == size_hint::upper_bound(6));
+		REQUIRE(cached.size() == 3);
+		REQUIRE(cached.size_hint() == size_hint::exact(3));
+	}
+
+	SECTION("Infinite generators"){
+		REQUIRE(infinite(1).size_hint() == size_hint::infinite());
+		REQUIRE(cycle(v).size_hint() == size_hint::infinite());
+		REQUIRE((v | zip(infinite(1))).size_hint() == size_hint::exact(6));
+	}
+}
+
+namespace {
+
+// Allocator counting calls to allocate().
+template<class T>
+struct counting_allocator {
+	using value_type = T;
+
+	explicit counting_allocator(unsigned *allocationCount) : allocations(allocationCount) {}
+
+	template<class U>
+	counting_allocator(const counting_allocator<U> &other) : allocations(other.allocations) {}
+
+	T *
+	allocate(size_t n) {
+		++*allocations;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void
+	deallocate(T *p, size_t n) {
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<class U>
+	bool
+	operator==(const counting_allocator<U> &other) const {
+		return allocations == other.allocations;
+	}
+
+	template<class U>
+	bool
+	operator!=(const counting_allocator<U> &other) const {
+		return allocations != other.allocations;
+	}
+
+	unsigned *allocations;
+};
+
+}
+
+TEST_CASE( "Materializing stages reserve", "[size_hint_test]" ) {
+	const list<int> l{ 1, 2, 3, 4, 5 };
+	unsigned allocations = 0;
+	const auto cached = l
+		| transform([](int i){ return i * 2; })
+		| cache(counting_allocator<int>(&allocations));
+	vector<int> out;
+	cached | copy_to(std::back_inserter(out));
+	REQUIRE((vector<int>{ 2, 4, 6, 8, 10 }) == out);
+	REQUIRE(allocations == 1u);
+}
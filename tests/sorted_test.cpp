@@ -1,8 +1,17 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include <catch.hpp>
 
+#include <tpl/executor.hpp>
 #include <tpl/operator/sorted.hpp>
+#include <tpl/operator/take.hpp>
+#include <tpl/operator/transformed.hpp>
 
+#include <algorithm>
+#include <forward_list>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -33,3 +42,357 @@ TEST_CASE( "Vector sorting", "[sorted_test]" ) {
 		REQUIRE(v == result);
 	}
 }
+
+TEST_CASE( "Sorting materialization", "[sorted_test]" ) {
+	vector<int> v{ 3, 1, 2 };
+	unsigned comparisons = 0;
+	const auto counting = [&comparisons](int i, int j){ ++comparisons; return i < j; };
+
+	SECTION("Sorted once"){
+		const auto vf = v | sort(counting, materialize_once);
+		vector<int> result(vf.begin(), vf.end());
+		const auto afterFirst = comparisons;
+		REQUIRE(afterFirst > 0);
+		vector<int> again(vf.begin(), vf.end());
+		REQUIRE(afterFirst == comparisons);
+		REQUIRE((vector<int>{ 1, 2, 3 }) == again);
+	}
+
+	SECTION("Stale until refreshed"){
+		const auto vf = v | sort(counting, multiset_sort, materialize_once);
+		vf.begin();
+		v = { 5, 4 };
+		REQUIRE((vector<int>{ 1, 2, 3 }) == vector<int>(vf.begin(), vf.end()));
+		vf.refresh();
+		REQUIRE((vector<int>{ 4, 5 }) == vector<int>(vf.begin(), vf.end()));
+	}
+
+	SECTION("Preserved by take"){
+		const auto vf = v | sort(counting, materialize_once) | take(2);
+		vf.begin();
+		v = { 5, 4 };
+		REQUIRE((vector<int>{ 1, 2 }) == vector<int>(vf.begin(), vf.end()));
+		vf.refresh();
+		REQUIRE((vector<int>{ 4, 5 }) == vector<int>(vf.begin(), vf.end()));
+	}
+}
+
+TEST_CASE( "Sorting policies", "[sorted_test]" ) {
+	vector<pair<int, int>> v{ {3, 0}, {1, 1}, {2, 2}, {1, 3}, {3, 4}, {2, 5} };
+	auto byFirst = [](const auto &i, const auto &j){ return i.first < j.first; };
+	const vector<pair<int, int>> expected{ {1, 1}, {1, 3}, {2, 2}, {2, 5}, {3, 0}, {3, 4} };
+
+	SECTION("contiguous_sort keeps order of equivalent elements"){
+		const auto vf = v | sort(byFirst, contiguous_sort);
+		vector<pair<int, int>> result(vf.begin(), vf.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("multiset_sort keeps order of equivalent elements"){
+		const auto vf = v | sort(byFirst, multiset_sort);
+		vector<pair<int, int>> result(vf.begin(), vf.end());
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Iterator category"){
+		const auto contiguous = v | sort(byFirst);
+		const auto multiset = v | sort(byFirst, multiset_sort);
+		REQUIRE((std::is_same<
+			iterator_traits<decltype(contiguous.begin())>::iterator_category,
+			random_access_iterator_tag
+		>::value));
+		REQUIRE((std::is_same<
+			iterator_traits<decltype(multiset.begin())>::iterator_category,
+			bidirectional_iterator_tag
+		>::value));
+		const auto first = contiguous.begin();
+		REQUIRE(contiguous.end() - first == 6);
+		REQUIRE(first[4] == make_pair(3, 0));
+	}
+}
+
+TEST_CASE( "Parallel sorting", "[sorted_test]" ) {
+	executor pool(3);
+	vector<pair<int, int>> v;
+	for (int i = 0; i < 20000; ++i)
+		v.emplace_back((i * 7919) % 101, i);
+	auto byFirst = [](const auto &i, const auto &j){ return i.first < j.first; };
+	const auto sequential = v | sort(byFirst);
+	const vector<pair<int, int>> expected(sequential.begin(), sequential.end());
+
+	SECTION("Same order as sequential sort"){
+		for (unsigned chunks : { 1u, 2u, 3u, 5u, 8u }) {
+			const auto vf = v | sort(byFirst, par(pool)(chunks));
+			REQUIRE((expected == vector<pair<int, int>>(vf.begin(), vf.end())));
+		}
+		const auto vf = v | sort(byFirst, par);
+		REQUIRE((expected == vector<pair<int, int>>(vf.begin(), vf.end())));
+	}
+
+	SECTION("Materialization and take"){
+		const auto once = v | sort(byFirst, par(pool), materialize_once);
+		REQUIRE((expected == vector<pair<int, int>>(once.begin(), once.end())));
+		const auto taken = v | sort(byFirst, par(pool)) | take(3);
+		REQUIRE((vector<pair<int, int>>(expected.begin(), expected.begin() + 3) ==
+			vector<pair<int, int>>(taken.begin(), taken.end())));
+	}
+}
+
+TEST_CASE( "Lazy sorting", "[sorted_test]" ) {
+	vector<pair<int, int>> v;
+	for (int i = 0; i < 10000; ++i)
+		v.emplace_back((i * 7919) % 257, i);
+	unsigned comparisons = 0;
+	auto byFirst = [&comparisons](const auto &i, const auto &j){ ++comparisons; return i.first < j.first; };
+
+	SECTION("Same order as sort"){
+		const auto lazy = v | lazy_sort(byFirst);
+		const auto eager = v | sort(byFirst);
+		REQUIRE((vector<pair<int, int>>(eager.begin(), eager.end()) ==
+			vector<pair<int, int>>(lazy.begin(), lazy.end())));
+		REQUIRE((std::is_same<
+			iterator_traits<decltype(lazy.begin())>::iterator_category,
+			forward_iterator_tag
+		>::value));
+	}
+
+	SECTION("Only consumed elements are ordered"){
+		const auto lazy = v | lazy_sort(byFirst);
+		vector<pair<int, int>> firstThree;
+		for (const auto &value : lazy) {
+			firstThree.push_back(value);
+			if (firstThree.size() == 3)
+				break;
+		}
+		REQUIRE((vector<pair<int, int>>{ {0, 0}, {0, 257}, {0, 514} } == firstThree));
+		REQUIRE(comparisons < 4 * v.size());
+	}
+
+	SECTION("Iterators are multi-pass"){
+		const auto lazy = vector<int>{ 3, 1, 2 } | lazy_sort(std::less<>(), materialize_once);
+		const auto first = lazy.begin();
+		auto second = first;
+		++second;
+		REQUIRE(*second == 2);
+		REQUIRE(*first == 1);
+		REQUIRE(std::distance(lazy.begin(), lazy.end()) == 3);
+		REQUIRE(vector<int>(lazy.begin(), lazy.end()) == (vector<int>{ 1, 2, 3 }));
+	}
+
+	SECTION("Default constructed iterators are at the end"){
+		const auto lazy = vector<int>{ 3, 1, 2 } | lazy_sort(std::less<>(), materialize_once);
+		const decltype(lazy.begin()) none{};
+		REQUIRE(none == decltype(lazy.begin()){});
+		REQUIRE(none == lazy.end());
+		REQUIRE(lazy.begin() != none);
+	}
+}
+
+struct string_serializer {
+	void write(std::ostream &stream, const string &value) const {
+		stream << value.size() << ' ' << value;
+	}
+
+	bool read(std::istream &stream, string &value) const {
+		size_t size;
+		if (!(stream >> size) || stream.get() != ' ')
+			return false;
+		value.resize(size);
+		return static_cast<bool>(stream.read(&value[0], static_cast<std::streamsize>(size)));
+	}
+};
+
+TEST_CASE( "External sorting", "[sorted_test]" ) {
+	vector<pair<int, int>> v;
+	for (int i = 0; i < 5000; ++i)
+		v.emplace_back((i * 7919) % 257, i);
+	auto byFirst = [](const auto &i, const auto &j){ return i.first < j.first; };
+	const auto inMemory = v | sort(byFirst);
+	const vector<pair<int, int>> expected(inMemory.begin(), inMemory.end());
+
+	SECTION("Same order as sort"){
+		for (size_t budget : { 10 * sizeof(pair<int, int>), 1000 * sizeof(pair<int, int>), size_t(1) << 20 }) {
+			const auto external = v | external_sort(byFirst, budget, ".");
+			REQUIRE((expected == vector<pair<int, int>>(external.begin(), external.end())));
+			REQUIRE((expected == vector<pair<int, int>>(external.begin(), external.end())));
+		}
+	}
+
+	SECTION("Custom serializer"){
+		const vector<string> words{ "pear", "apple fruit", "", "fig", "banana", "apple" };
+		const auto external = words | external_sort(std::less<>(), 2 * sizeof(string), ".", string_serializer());
+		REQUIRE((vector<string>{ "", "apple", "apple fruit", "banana", "fig", "pear" } ==
+			vector<string>(external.begin(), external.end())));
+	}
+
+	SECTION("Spill files are removed"){
+		string path;
+		{
+			detail::spill_files files(".");
+			path = files.add();
+			ofstream(path) << "run";
+			REQUIRE(ifstream(path).good());
+		}
+		REQUIRE_FALSE(ifstream(path).good());
+	}
+}
+
+TEST_CASE( "Sorting by projection", "[sorted_test]" ) {
+	const vector<string> v{ "delta", "Alpha", "charlie", "alpha", "Bravo", "ALPHA" };
+	unsigned projections = 0;
+	const auto lowercase = [&projections](const string &text) {
+		++projections;
+		string result(text);
+		std::transform(result.begin(), result.end(), result.begin(), [](char c){ return char(tolower(c)); });
+		return result;
+	};
+
+	SECTION("Projection is called once per element"){
+		const auto vf = v | sort_by(lowercase);
+		REQUIRE((vector<string>{ "Alpha", "alpha", "ALPHA", "Bravo", "charlie", "delta" } ==
+			vector<string>(vf.begin(), vf.end())));
+		REQUIRE(projections == v.size());
+	}
+
+	SECTION("Projection is called once per element when followed by take"){
+		const auto vf = v | sort_by(lowercase) | take(3);
+		REQUIRE((vector<string>{ "Alpha", "alpha", "ALPHA" } ==
+			vector<string>(vf.begin(), vf.end())));
+		REQUIRE(projections == v.size());
+
+		unsigned keys = 0;
+		vector<int> input(10000);
+		for (unsigned i = 0; i < input.size(); ++i)
+			input[i] = static_cast<int>((i * 7919) % 10000);
+		const auto top = input
+			| sort_by_key([&keys](int i){ ++keys; return -i; })
+			| take(100);
+		const vector<int> result(top.begin(), top.end());
+		REQUIRE(result.front() == 9999);
+		REQUIRE(result.back() == 9900);
+		REQUIRE(keys == input.size());
+	}
+
+	SECTION("Custom key comparison"){
+		const auto vf = v | sort_by([](const string &text){ return text.size(); }, std::greater<>());
+		REQUIRE((vector<string>{ "charlie", "delta", "Alpha", "alpha", "Bravo", "ALPHA" } ==
+			vector<string>(vf.begin(), vf.end())));
+	}
+}
+
+TEST_CASE( "Sorting by key", "[sorted_test]" ) {
+	const auto expectedOrder = [](auto input, auto comparison) {
+		std::stable_sort(input.begin(), input.end(), comparison);
+		return input;
+	};
+
+	SECTION("Integral keys"){
+		vector<pair<long long, int>> v;
+		for (int i = 0; i < 5000; ++i)
+			v.emplace_back(((i * 7919LL) % 1013 - 500) * 1000000007LL, i);
+		const auto first = [](const auto &p){ return p.first; };
+
+		const auto ascending = v | sort_by_key(first);
+		REQUIRE((expectedOrder(v, [](const auto &a, const auto &b){ return a.first < b.first; }) ==
+			vector<pair<long long, int>>(ascending.begin(), ascending.end())));
+
+		const auto descending = v | sort_by_key(first, std::greater<>());
+		REQUIRE((expectedOrder(v, [](const auto &a, const auto &b){ return a.first > b.first; }) ==
+			vector<pair<long long, int>>(descending.begin(), descending.end())));
+
+		vector<unsigned char> bytes{ 200, 3, 255, 0, 17, 3 };
+		bytes.resize(100, 42);
+		const auto sortedBytes = bytes | sort_by_key([](unsigned char b){ return b; });
+		REQUIRE((expectedOrder(bytes, std::less<>()) == vector<unsigned char>(sortedBytes.begin(), sortedBytes.end())));
+	}
+
+	SECTION("Floating point keys"){
+		vector<pair<double, int>> v;
+		for (int i = 0; i < 1000; ++i)
+			v.emplace_back(((i * 37) % 101 - 50) / 4.0, i);
+		v.emplace_back(-0.0, 1000);
+		v.emplace_back(0.0, 1001);
+		v.emplace_back(-0.0, 1002);
+		const auto vf = v | sort_by_key([](const auto &p){ return p.first; });
+		REQUIRE((expectedOrder(v, [](const auto &a, const auto &b){ return a.first < b.first; }) ==
+			vector<pair<double, int>>(vf.begin(), vf.end())));
+	}
+
+	SECTION("Other keys and short inputs"){
+		const vector<pair<string, int>> v{ {"b", 0}, {"a", 1}, {"b", 2}, {"a", 3} };
+		const auto vf = v | sort_by_key([](const auto &p){ return p.first; });
+		REQUIRE((vector<pair<string, int>>{ {"a", 1}, {"a", 3}, {"b", 0}, {"b", 2} } ==
+			vector<pair<string, int>>(vf.begin(), vf.end())));
+
+		const vector<int> shortVector{ 3, -1, 2 };
+		const auto sortedShort = shortVector | sort_by_key([](int i){ return i; }) | take(2);
+		REQUIRE((vector<int>{ -1, 2 } == vector<int>(sortedShort.begin(), sortedShort.end())));
+	}
+}
+
+TEST_CASE( "Sorting followed by take", "[sorted_test]" ) {
+	vector<pair<int, int>> v{ {3, 0}, {1, 1}, {2, 2}, {1, 3}, {3, 4}, {2, 5}, {0, 6} };
+	auto byFirst = [](const auto &i, const auto &j){ return i.first < j.first; };
+
+	SECTION("Fused when applied directly"){
+		const auto vf = v | sort(byFirst) | take(4);
+		REQUIRE((std::is_same<
+			typename std::decay<decltype(vf)>::type,
+			partially_sorted_sequence<vector<pair<int, int>> &, decltype(byFirst) &>
+		>::value));
+		vector<pair<int, int>> result(vf.begin(), vf.end());
+		const vector<pair<int, int>> expected{ {0, 6}, {1, 1}, {1, 3}, {2, 2} };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Fused when composed"){
+		const auto topThree = sort(byFirst, multiset_sort) | take(3);
+		const auto vf = v | topThree;
+		vector<pair<int, int>> result(vf.begin(), vf.end());
+		const vector<pair<int, int>> expected{ {0, 6}, {1, 1}, {1, 3} };
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Taking more than size"){
+		const auto vf = v | sort(byFirst) | take(10);
+		vector<pair<int, int>> result(vf.begin(), vf.end());
+		vector<pair<int, int>> expected(v);
+		std::stable_sort(expected.begin(), expected.end(), byFirst);
+		REQUIRE(expected == result);
+	}
+
+	SECTION("Taking nothing"){
+		const auto vf = v | sort(byFirst) | take(0);
+		REQUIRE(vf.begin() == vf.end());
+	}
+
+	SECTION("Comparisons are bounded by N log(k)"){
+		vector<int> input(1000);
+		for (unsigned i = 0; i < input.size(); ++i)
+			input[i] = static_cast<int>((i * 7919) % 1000);
+		unsigned comparisons = 0;
+		const auto vf = input |
+			sort([&comparisons](int i, int j){ ++comparisons; return i < j; }) |
+			take(3);
+		vector<int> result(vf.begin(), vf.end());
+		REQUIRE((vector<int>{ 0, 1, 2 }) == result);
+		REQUIRE(comparisons < 4 * input.size());
+	}
+
+	SECTION("Taking more than unknown size"){
+		const forward_list<int> input{ 3, 1, 2 };
+		const auto vf = input | sort(std::less<>()) | take(400000000u);
+		REQUIRE((vector<int>{ 1, 2, 3 }) == vector<int>(vf.begin(), vf.end()));
+	}
+
+	SECTION("Elements are read once"){
+		const vector<int> input{ 5, 3, 8, 1, 9, 2, 7 };
+		unsigned reads = 0;
+		const auto vf = input |
+			transform([&reads](int i){ ++reads; return i; }) |
+			sort(std::less<>()) |
+			take(3);
+		REQUIRE((vector<int>{ 1, 2, 3 }) == vector<int>(vf.begin(), vf.end()));
+		REQUIRE(reads == input.size());
+	}
+}
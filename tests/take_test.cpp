@@ -2,9 +2,15 @@
 #include <catch.hpp>
 
 #include <tpl/operator/take.hpp>
+#include <tpl/operator/filtered.hpp>
+#include <tpl/generator/generator.hpp>
+#include <tpl/generator/infinite.hpp>
 
 #include <string>
 #include <algorithm>
+#include <iterator>
+#include <list>
+#include <type_traits>
 #include <vector>
 
 using namespace std;
@@ -32,3 +38,36 @@ TEST_CASE( "Testing taking from sequence", "[take_test]" ) {
 		REQUIRE(out2 == in);
 	}
 }
+
+TEST_CASE( "Taking from sequences without random access", "[take_test]" ) {
+	SECTION("Take from list") {
+		const list<int> in = { 1, 2, 3, 4 };
+		const auto result = in | take(2);
+		const auto result2 = in | take(6);
+		REQUIRE((vector<int>{ 1, 2 }) == vector<int>(result.begin(), result.end()));
+		REQUIRE((vector<int>{ 1, 2, 3, 4 }) == vector<int>(result2.begin(), result2.end()));
+		REQUIRE((is_same<
+			iterator_traits<decltype(result.begin())>::iterator_category,
+			forward_iterator_tag
+		>::value));
+	}
+
+	SECTION("Take from infinite sequence") {
+		const auto result = infinite(7) | take(3);
+		REQUIRE((vector<int>{ 7, 7, 7 }) == vector<int>(result.begin(), result.end()));
+	}
+
+	SECTION("Take from filtered generator") {
+		unsigned generated = 0;
+		const auto result = generator([&generated](int i){ ++generated; return i + 1; }, 0) |
+			filter([](int i){ return i % 3 == 0; }) |
+			take(4);
+		REQUIRE((vector<int>{ 0, 3, 6, 9 }) == vector<int>(result.begin(), result.end()));
+		REQUIRE(generated == 9u);
+	}
+
+	SECTION("Take nothing") {
+		const auto result = infinite(1) | take(0);
+		REQUIRE(result.begin() == result.end());
+	}
+}
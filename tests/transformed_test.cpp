@@ -79,3 +79,36 @@ TEST_CASE( "Checking swap operation", "[transformed_test]" ) {
 	REQUIRE(*start == false);
 	REQUIRE(*second == true);
 }
+
+TEST_CASE( "Transforming preserves iterator category", "[transformed_test]" ) {
+	using namespace std;
+	using namespace tpl;
+	const vector<int> v{ 1, 2, 3, 4, 5 };
+	const list<int> l{ 1, 2, 3 };
+	const auto square = [](int i){ return i * i; };
+
+	SECTION("Random access"){
+		const auto vf = v | transform(square);
+		auto first = vf.begin();
+		REQUIRE((is_same<
+			iterator_traits<decltype(first)>::iterator_category,
+			random_access_iterator_tag
+		>::value));
+		REQUIRE(vf.end() - first == 5);
+		REQUIRE(*(first + 3) == 16);
+		REQUIRE(first[4] == 25);
+		REQUIRE(first < first + 1);
+		first += 2;
+		REQUIRE(*first == 9);
+		REQUIRE(*(first - 1) == 4);
+	}
+
+	SECTION("Bidirectional"){
+		const auto lf = l | transform(square);
+		REQUIRE((is_same<
+			iterator_traits<decltype(lf.begin())>::iterator_category,
+			bidirectional_iterator_tag
+		>::value));
+		REQUIRE(*std::prev(lf.end()) == 9);
+	}
+}
@@ -2,9 +2,15 @@
 #include <catch.hpp>
 
 #include <tpl/operator/zipped.hpp>
+#include <tpl/operator/transformed.hpp>
 
 #include <vector>
 #include <list>
+#include <string>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
 
 TEST_CASE( "Vector zipping", "[zipped_test]" ) {
 	using namespace std;
@@ -60,3 +66,105 @@ TEST_CASE( "Compilation tests", "[zipped_test]" ) {
 					listAndvectorIterator));
 	}
 }
+
+TEST_CASE( "Zipping iterator category", "[zipped_test]" ) {
+	using namespace std;
+	using namespace tpl;
+	vector<int> v1{ 1, 2, 3, 4, 5 };
+	vector<int> v2{ 6, 7, 8 };
+	list<int> l{ 6, 7, 8 };
+
+	SECTION("Random access when both are random access"){
+		const auto vf = v1 | zip(v2);
+		REQUIRE((is_same<
+			iterator_traits<decltype(vf.begin())>::iterator_category,
+			random_access_iterator_tag
+		>::value));
+		REQUIRE(vf.end() - vf.begin() == 3);
+		REQUIRE(vf.begin() - vf.end() == -3);
+		REQUIRE(vf.begin()[2] == make_pair(3, 8));
+		REQUIRE(vf.begin() + 3 == vf.end());
+	}
+
+	SECTION("Bidirectional when one is bidirectional"){
+		const auto vf = v1 | zip(l);
+		REQUIRE((is_same<
+			iterator_traits<decltype(vf.begin())>::iterator_category,
+			bidirectional_iterator_tag
+		>::value));
+		REQUIRE(std::distance(vf.begin(), vf.end()) == 3);
+	}
+}
+
+namespace {
+
+// Counts copies made of it, to check that zipping does not copy elements.
+struct copy_counter {
+	explicit copy_counter(unsigned *copyCount) : copies(copyCount) {}
+
+	copy_counter(const copy_counter &other) : copies(other.copies) {
+		++*copies;
+	}
+
+	bool
+	operator==(const copy_counter &other) const {
+		return copies == other.copies;
+	}
+
+	unsigned *copies;
+};
+
+}
+
+TEST_CASE( "Zipping without copies", "[zipped_test]" ) {
+	using namespace std;
+	using namespace tpl;
+	vector<string> names{ "a", "b", "c" };
+	vector<int> ids{ 1, 2, 3 };
+
+	SECTION("Iterators reference elements in place"){
+		const auto vf = names | zip(ids);
+		auto it = vf.begin();
+		REQUIRE(&(*it).first == &names[0]);
+		REQUIRE(&it->second == &ids[0]);
+		REQUIRE(&vf.begin()[2].first == &names[2]);
+	}
+
+	SECTION("Pairs convert to value type"){
+		const auto vf = names | zip(ids);
+		const vector<pair<string, int>> result(vf.begin(), vf.end());
+		REQUIRE((result == vector<pair<string, int>>{ { "a", 1 }, { "b", 2 }, { "c", 3 } }));
+		REQUIRE((*vf.begin() == make_pair(string("a"), 1)));
+		REQUIRE((make_pair(string("b"), 2) != *vf.begin()));
+	}
+
+	SECTION("Elements returned by value are stored in pairs"){
+		const auto vf = ids
+			| transform([](int i){ return i * 10; })
+			| zip(names);
+		REQUIRE((*vf.begin() == make_pair(10, string("a"))));
+	}
+
+	SECTION("Folding copies no element"){
+		unsigned copies = 0;
+		const vector<copy_counter> counters(3, copy_counter(&copies));
+		copies = 0;
+		const auto zipped = counters | zip(ids);
+		const auto sum = accumulate(
+			zipped.begin(),
+			zipped.end(),
+			0,
+			[](int acc, const auto &pair){ return acc + pair.second; }
+		);
+		REQUIRE(sum == 6);
+		REQUIRE(copies == 0u);
+
+		unsigned visited = 0;
+		zipped.for_each([&visited](const auto &pair){
+			REQUIRE(pair.first.copies != nullptr);
+			++visited;
+		});
+		REQUIRE(visited == 3u);
+		REQUIRE(copies == 0u);
+	}
+}